@@ -10,7 +10,8 @@
 #include <lexy/input/file.hpp>
 #include <lexy_ext/cfile.hpp>
 
-std::size_t use_buffer(const lexy::buffer<>& buffer)
+template <typename Buffer>
+std::size_t use_buffer(const Buffer& buffer)
 {
     std::size_t sum = 0;
     for (auto c : buffer)
@@ -27,6 +28,17 @@ std::size_t file_lexy(const char* path)
     auto result = lexy::read_file(path);
     return use_buffer(result.value());
 }
+std::size_t file_lexy_utf16(const char* path)
+{
+    // The file is in native byte order, so this needs a conversion on little endian platforms.
+    auto result = lexy::read_file<lexy::utf16_encoding, lexy::encoding_endianness::big>(path);
+    return use_buffer(result.value());
+}
+std::size_t file_lexy_utf32(const char* path)
+{
+    auto result = lexy::read_file<lexy::utf32_encoding, lexy::encoding_endianness::big>(path);
+    return use_buffer(result.value());
+}
 std::size_t file_lexy_cfile(const char* path)
 {
     auto file   = std::fopen(path, "rb");
@@ -91,6 +103,8 @@ int main()
 
         b.run("lexy", benchmark(file_lexy));
         b.run("lexy_cfile", benchmark(file_lexy_cfile));
+        b.run("lexy_utf16", benchmark(file_lexy_utf16));
+        b.run("lexy_utf32", benchmark(file_lexy_utf32));
 
         b.run("cfile", benchmark(file_cfile));
         b.run("stream", benchmark(file_stream));
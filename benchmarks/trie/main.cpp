@@ -0,0 +1,87 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+#include <nanobench.h>
+
+#include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/trie.hpp>
+#include <lexy/input/buffer.hpp>
+#include <string>
+
+// The keywords of C; the root node has a transition for 15 different characters.
+constexpr auto keywords = lexy::trie<
+    char, LEXY_NTTP_STRING("auto"), LEXY_NTTP_STRING("break"), LEXY_NTTP_STRING("case"),
+    LEXY_NTTP_STRING("char"), LEXY_NTTP_STRING("const"), LEXY_NTTP_STRING("continue"),
+    LEXY_NTTP_STRING("default"), LEXY_NTTP_STRING("do"), LEXY_NTTP_STRING("double"),
+    LEXY_NTTP_STRING("else"), LEXY_NTTP_STRING("enum"), LEXY_NTTP_STRING("extern"),
+    LEXY_NTTP_STRING("float"), LEXY_NTTP_STRING("for"), LEXY_NTTP_STRING("goto"),
+    LEXY_NTTP_STRING("if"), LEXY_NTTP_STRING("inline"), LEXY_NTTP_STRING("int"),
+    LEXY_NTTP_STRING("long"), LEXY_NTTP_STRING("register"), LEXY_NTTP_STRING("restrict"),
+    LEXY_NTTP_STRING("return"), LEXY_NTTP_STRING("short"), LEXY_NTTP_STRING("signed"),
+    LEXY_NTTP_STRING("sizeof"), LEXY_NTTP_STRING("static"), LEXY_NTTP_STRING("struct"),
+    LEXY_NTTP_STRING("switch"), LEXY_NTTP_STRING("typedef"), LEXY_NTTP_STRING("union"),
+    LEXY_NTTP_STRING("unsigned"), LEXY_NTTP_STRING("void"), LEXY_NTTP_STRING("volatile"),
+    LEXY_NTTP_STRING("while")>;
+
+// Words separated by a single space: mostly keywords, some identifiers that aren't.
+lexy::buffer<> make_input(std::size_t size)
+{
+    const char* words[] = {"int",  "x",      "while", "return", "struct", "foo",  "unsigned",
+                           "long", "double", "if",    "else",   "bar",    "void", "static"};
+
+    std::string result;
+    for (auto i = std::size_t(0); result.size() < size; ++i)
+    {
+        result += words[(i * 7) % (sizeof(words) / sizeof(words[0]))];
+        result += ' ';
+    }
+    return lexy::buffer<>(result.data(), result.size());
+}
+
+template <typename Engine>
+std::size_t count_keywords(const lexy::buffer<>& input)
+{
+    auto count  = std::size_t(0);
+    auto reader = input.reader();
+    while (!reader.eof())
+    {
+        if (Engine::match(reader) == typename Engine::error_code())
+            ++count;
+
+        // Skip the rest of the word and the space.
+        while (reader.peek() != ' ')
+            reader.bump();
+        reader.bump();
+    }
+    return count;
+}
+
+int main()
+{
+    ankerl::nanobench::Bench b;
+
+    auto bench_data = [&](const char* title, std::size_t size) {
+        auto input = make_input(size);
+
+        b.minEpochIterations(100);
+        b.title(title).relative(true);
+        b.unit("byte").batch(input.size());
+
+        // Compares every transition in turn.
+        b.run("linear", [&] {
+            using engine = lexy::engine_trie<keywords, std::size_t(-1)>;
+            return count_keywords<engine>(input);
+        });
+        // Uses the lookup table for nodes with many transitions.
+        b.run("table", [&] {
+            using engine = lexy::engine_trie<keywords>;
+            return count_keywords<engine>(input);
+        });
+    };
+
+    bench_data("4 KiB", 4 * 1024);
+    bench_data("64 KiB", 64 * 1024);
+    bench_data("1 MiB", 1024 * 1024);
+}
@@ -131,6 +131,61 @@ struct _char8_str
 #    endif
 #endif
 
+//=== is_constant_evaluated ===//
+#ifndef LEXY_HAS_IS_CONSTANT_EVALUATED
+#    if defined(__has_builtin)
+#        if __has_builtin(__builtin_is_constant_evaluated)
+#            define LEXY_HAS_IS_CONSTANT_EVALUATED 1
+#        endif
+#    endif
+#
+#    ifndef LEXY_HAS_IS_CONSTANT_EVALUATED
+#        if (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#            define LEXY_HAS_IS_CONSTANT_EVALUATED 1
+#        else
+#            define LEXY_HAS_IS_CONSTANT_EVALUATED 0
+#        endif
+#    endif
+#endif
+
+namespace lexy::_detail
+{
+constexpr bool is_constant_evaluated() noexcept
+{
+#if LEXY_HAS_IS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    // We can't tell, so we conservatively disable all runtime-only code paths.
+    return true;
+#endif
+}
+} // namespace lexy::_detail
+
+//=== SIMD ===//
+#ifndef LEXY_HAS_SSE2
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define LEXY_HAS_SSE2 1
+#    else
+#        define LEXY_HAS_SSE2 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_SSSE3
+#    if defined(__SSSE3__)
+#        define LEXY_HAS_SSSE3 1
+#    else
+#        define LEXY_HAS_SSSE3 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_AVX2
+#    if defined(__AVX2__)
+#        define LEXY_HAS_AVX2 1
+#    else
+#        define LEXY_HAS_AVX2 0
+#    endif
+#endif
+
 //=== force inline ===//
 #ifndef LEXY_FORCE_INLINE
 #    if defined(__has_cpp_attribute)
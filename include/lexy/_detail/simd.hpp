@@ -0,0 +1,936 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_DETAIL_SIMD_HPP_INCLUDED
+#define LEXY_DETAIL_SIMD_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+
+#if LEXY_HAS_SSE2
+#    include <emmintrin.h>
+#endif
+#if LEXY_HAS_SSSE3
+#    include <tmmintrin.h>
+#endif
+#if LEXY_HAS_AVX2
+#    include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
+//=== SWAR helpers ===//
+namespace lexy::_detail
+{
+using swar_int = std::uint64_t;
+
+// Bytes with only the low bits/high bit set.
+constexpr auto swar_low_bits  = swar_int(0x7F7F'7F7F'7F7F'7F7F);
+constexpr auto swar_high_bits = swar_int(0x8080'8080'8080'8080);
+
+constexpr swar_int swar_fill(unsigned char c)
+{
+    return swar_int(0x0101'0101'0101'0101) * c;
+}
+
+inline swar_int swar_load(const unsigned char* ptr) noexcept
+{
+    swar_int result;
+    std::memcpy(&result, ptr, sizeof(swar_int));
+    return result;
+}
+
+// Byte-wise subtraction without borrows between bytes.
+constexpr swar_int swar_sub(swar_int lhs, swar_int rhs)
+{
+    return ((lhs | swar_high_bits) - (rhs & swar_low_bits)) ^ ((lhs ^ ~rhs) & swar_high_bits);
+}
+
+// Sets the high bit of every byte equal to c.
+constexpr swar_int swar_eq(swar_int word, unsigned char c)
+{
+    // Bytes equal to c are zero after the xor, and the only ones where adding 0x7F doesn't set the
+    // high bit. As we've masked out the high bit before adding, there is no carry between bytes.
+    auto x = word ^ swar_fill(c);
+    auto t = ((x & swar_low_bits) + swar_low_bits) | x;
+    return ~t & swar_high_bits;
+}
+
+// Sets the high bit of every byte greater than c.
+constexpr swar_int swar_gt(swar_int word, unsigned char c)
+{
+    // The high bit is set if the lower seven bits are greater than those of c.
+    auto low_gt = ((word & swar_low_bits) + swar_fill(static_cast<unsigned char>(0x7F - (c & 0x7F))))
+                  & swar_high_bits;
+    if (c & 0x80)
+        // The byte needs to have the high bit set as well.
+        return word & low_gt;
+    else
+        // Either the high bit is set, or the lower bits are greater.
+        return (word | low_gt) & swar_high_bits;
+}
+
+inline unsigned countr_zero(swar_int value) noexcept
+{
+    LEXY_PRECONDITION(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_ctzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long result;
+    _BitScanForward64(&result, value);
+    return unsigned(result);
+#else
+    auto result = 0u;
+    for (; (value & 1) == 0; value >>= 1)
+        ++result;
+    return result;
+#endif
+}
+
+inline unsigned countl_zero(swar_int value) noexcept
+{
+    LEXY_PRECONDITION(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_clzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long result;
+    _BitScanReverse64(&result, value);
+    return 63 - unsigned(result);
+#else
+    auto result = 0u;
+    for (; (value & (swar_int(1) << 63)) == 0; value <<= 1)
+        ++result;
+    return result;
+#endif
+}
+
+// Loads the bytes such that the first one in memory is the least significant one.
+inline swar_int swar_load_le(const unsigned char* ptr) noexcept
+{
+#if LEXY_IS_LITTLE_ENDIAN
+    return swar_load(ptr);
+#else
+    auto result = swar_int(0);
+    for (auto i = 0u; i != sizeof(swar_int); ++i)
+        result |= swar_int(ptr[i]) << (8 * i);
+    return result;
+#endif
+}
+
+// Whether the N bytes at lhs and rhs are equal, compared a word at a time.
+// Words overlap instead of reading beyond the N bytes.
+template <std::size_t N>
+bool swar_equal(const unsigned char* lhs, const unsigned char* rhs) noexcept
+{
+    auto diff = [&](std::size_t offset, auto word) {
+        decltype(word) l, r;
+        std::memcpy(&l, lhs + offset, sizeof(word));
+        std::memcpy(&r, rhs + offset, sizeof(word));
+        return l ^ r;
+    };
+
+    if constexpr (N == 0)
+        return true;
+    else if constexpr (N == 1)
+        return *lhs == *rhs;
+    else if constexpr (N < 4)
+        return (diff(0, std::uint16_t()) | diff(N - 2, std::uint16_t())) == 0;
+    else if constexpr (N < 8)
+        return (diff(0, std::uint32_t()) | diff(N - 4, std::uint32_t())) == 0;
+    else
+    {
+        for (auto offset = std::size_t(0); offset + 8 < N; offset += 8)
+            if (diff(offset, swar_int()) != 0)
+                return false;
+        return diff(N - 8, swar_int()) == 0;
+    }
+}
+
+// Converts eight ASCII decimal digits, the first one being the least significant byte, into their
+// value.
+constexpr std::uint_least32_t swar_parse_decimal8(swar_int word)
+{
+    // Convert each byte to its digit value.
+    word -= swar_fill('0');
+    // Combine neighboring bytes into a two digit value, stored in every other byte.
+    word = word * 10 + (word >> 8);
+    // Combine the two digit values into an eight digit value, which ends up in the upper half.
+    constexpr auto mul1 = swar_int(100) + (swar_int(1'000'000) << 32);
+    constexpr auto mul2 = swar_int(1) + (swar_int(10'000) << 32);
+    word = ((word & 0x0000'00FF'0000'00FF) * mul1 + ((word >> 16) & 0x0000'00FF'0000'00FF) * mul2)
+           >> 32;
+    return static_cast<std::uint_least32_t>(word);
+}
+
+// Whether all eight bytes are ASCII decimal digits.
+constexpr bool swar_is_decimal8(swar_int word)
+{
+    // Adding 0x46 sets the high bit of bytes above '9', subtracting '0' of bytes below '0'.
+    // A carry or borrow into the next byte is only possible if the byte itself is flagged.
+    return (((word + swar_fill(0x46)) | (word - swar_fill('0'))) & swar_high_bits) == 0;
+}
+
+// Converts eight ASCII hexadecimal digits of either case, the first one being the least
+// significant byte, into their value.
+constexpr std::uint_least32_t swar_parse_hex8(swar_int word)
+{
+    // Digits have the value in the lower nibble, letters have bit 6 set and are off by nine.
+    word = (word & swar_fill(0x0F)) + ((word >> 6) & swar_fill(0x01)) * 9;
+    // Combine the nibbles, where the first byte is the most significant one.
+    word = ((word & 0x0F00'0F00'0F00'0F00) >> 8) | ((word & 0x000F'000F'000F'000F) << 4);
+    word = ((word & 0x00FF'0000'00FF'0000) >> 16) | ((word & 0x0000'00FF'0000'00FF) << 8);
+    word = ((word & 0x0000'FFFF'0000'0000) >> 32) | ((word & 0x0000'0000'0000'FFFF) << 16);
+    return static_cast<std::uint_least32_t>(word);
+}
+
+// Returns the index of the first byte in memory order whose high bit is set.
+inline std::size_t swar_first_byte(swar_int mask) noexcept
+{
+#if LEXY_IS_LITTLE_ENDIAN
+    return countr_zero(mask) / 8;
+#else
+    return countl_zero(mask) / 8;
+#endif
+}
+} // namespace lexy::_detail
+
+//=== byte_class ===//
+namespace lexy::_detail
+{
+/// An inclusive range of bytes.
+template <unsigned char Min, unsigned char Max>
+struct byte_range
+{
+    static_assert(Min <= Max);
+
+    static constexpr bool contains(unsigned char c)
+    {
+        return Min <= c && c <= Max;
+    }
+
+    // Sets the high bit of every byte in the range.
+    static constexpr swar_int swar(swar_int word)
+    {
+        if constexpr (Min == Max)
+            return swar_eq(word, Min);
+        else if constexpr (Min == 0)
+            return ~swar_gt(word, Max) & swar_high_bits;
+        else
+            return ~swar_gt(swar_sub(word, swar_fill(Min)), static_cast<unsigned char>(Max - Min))
+                   & swar_high_bits;
+    }
+
+#if LEXY_HAS_SSE2
+    // Sets all bits of every byte in the range.
+    static __m128i sse2(__m128i v) noexcept
+    {
+        if constexpr (Min == Max)
+            return _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(Min)));
+        else
+        {
+            // (v - Min) <= (Max - Min), using unsigned saturation to compare.
+            auto offset = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(Min)));
+            auto excess = _mm_subs_epu8(offset, _mm_set1_epi8(static_cast<char>(Max - Min)));
+            return _mm_cmpeq_epi8(excess, _mm_setzero_si128());
+        }
+    }
+#endif
+
+#if LEXY_HAS_AVX2
+    // Sets all bits of every byte in the range.
+    static __m256i avx2(__m256i v) noexcept
+    {
+        if constexpr (Min == Max)
+            return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(Min)));
+        else
+        {
+            auto offset = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(Min)));
+            auto excess = _mm256_subs_epu8(offset, _mm256_set1_epi8(static_cast<char>(Max - Min)));
+            return _mm256_cmpeq_epi8(excess, _mm256_setzero_si256());
+        }
+    }
+#endif
+};
+
+/// A set of bytes described by the union of `byte_range`s.
+template <typename... Ranges>
+struct byte_class
+{
+    static_assert(sizeof...(Ranges) > 0);
+
+    // As a scanner, it finds the bytes of the class.
+    using first_class = byte_class;
+
+    static constexpr bool contains(unsigned char c)
+    {
+        return (Ranges::contains(c) || ...);
+    }
+
+    static constexpr swar_int swar(swar_int word)
+    {
+        return (Ranges::swar(word) | ...);
+    }
+
+#if LEXY_HAS_SSE2
+    static __m128i sse2(__m128i v) noexcept
+    {
+        auto result = _mm_setzero_si128();
+        ((result = _mm_or_si128(result, Ranges::sse2(v))), ...);
+        return result;
+    }
+#endif
+
+#if LEXY_HAS_AVX2
+    static __m256i avx2(__m256i v) noexcept
+    {
+        auto result = _mm256_setzero_si256();
+        ((result = _mm256_or_si256(result, Ranges::avx2(v))), ...);
+        return result;
+    }
+#endif
+
+    /// Returns a pointer to the first byte in the class, or end.
+    static const unsigned char* find(const unsigned char* cur, const unsigned char* end) noexcept;
+    /// Returns a pointer to the first byte not in the class, or end.
+    static const unsigned char* find_not(const unsigned char* cur,
+                                         const unsigned char* end) noexcept;
+
+    /// Same as above, but may read up to `input_padding` bytes past end.
+    static const unsigned char* find_padded(const unsigned char* cur,
+                                            const unsigned char* end) noexcept;
+    static const unsigned char* find_not_padded(const unsigned char* cur,
+                                                const unsigned char* end) noexcept;
+};
+
+/// A set consisting of the specified bytes.
+template <unsigned char... Bytes>
+using byte_set = byte_class<byte_range<Bytes, Bytes>...>;
+
+template <typename... Classes>
+struct _byte_class_union;
+template <typename... Ranges>
+struct _byte_class_union<byte_class<Ranges...>>
+{
+    using type = byte_class<Ranges...>;
+};
+template <typename... Ranges1, typename... Ranges2, typename... Tail>
+struct _byte_class_union<byte_class<Ranges1...>, byte_class<Ranges2...>, Tail...>
+: _byte_class_union<byte_class<Ranges1..., Ranges2...>, Tail...>
+{};
+
+/// The union of the specified byte classes.
+template <typename... Classes>
+using byte_class_union = typename _byte_class_union<Classes...>::type;
+
+// The number of bytes `_byte_class_find_padded()` processes at once.
+#if LEXY_HAS_AVX2
+constexpr std::size_t padded_block_size = 32;
+#elif LEXY_HAS_SSE2
+constexpr std::size_t padded_block_size = 16;
+#else
+constexpr std::size_t padded_block_size = sizeof(swar_int);
+#endif
+
+// Returns the index of the first byte where the class matches (or doesn't match if Negate) in a
+// block of the given size. Returns the block size if there is none.
+template <typename Class, bool Negate>
+struct _byte_class_block
+{
+#if LEXY_HAS_AVX2
+    static std::size_t avx2(const unsigned char* ptr) noexcept
+    {
+        auto v    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(Class::avx2(v)));
+        if constexpr (Negate)
+            bits = ~bits;
+        return bits == 0 ? 32 : countr_zero(bits);
+    }
+#endif
+
+#if LEXY_HAS_SSE2
+    static std::size_t sse2(const unsigned char* ptr) noexcept
+    {
+        auto v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(Class::sse2(v)));
+        if constexpr (Negate)
+            bits = ~bits & 0xFFFF;
+        return bits == 0 ? 16 : countr_zero(bits);
+    }
+#endif
+
+    static std::size_t swar(const unsigned char* ptr) noexcept
+    {
+        auto mask = Class::swar(swar_load(ptr));
+        if constexpr (Negate)
+            mask = ~mask & swar_high_bits;
+        return mask == 0 ? 8 : swar_first_byte(mask);
+    }
+};
+
+template <typename Class, bool Negate>
+const unsigned char* _byte_class_find(const unsigned char* cur, const unsigned char* end) noexcept
+{
+    using block = _byte_class_block<Class, Negate>;
+
+#if LEXY_HAS_AVX2
+    for (; end - cur >= 32; cur += 32)
+        if (auto idx = block::avx2(cur); idx != 32)
+            return cur + idx;
+#endif
+#if LEXY_HAS_SSE2
+    for (; end - cur >= 16; cur += 16)
+        if (auto idx = block::sse2(cur); idx != 16)
+            return cur + idx;
+#endif
+    for (; end - cur >= 8; cur += 8)
+        if (auto idx = block::swar(cur); idx != 8)
+            return cur + idx;
+
+    while (cur != end && Class::contains(*cur) == Negate)
+        ++cur;
+    return cur;
+}
+
+// Same as above, but processes the tail with a full block, as it can read beyond end.
+template <typename Class, bool Negate>
+const unsigned char* _byte_class_find_padded(const unsigned char* cur,
+                                             const unsigned char* end) noexcept
+{
+    using block = _byte_class_block<Class, Negate>;
+
+    for (; cur < end; cur += padded_block_size)
+    {
+#if LEXY_HAS_AVX2
+        auto idx = block::avx2(cur);
+#elif LEXY_HAS_SSE2
+        auto idx = block::sse2(cur);
+#else
+        auto idx = block::swar(cur);
+#endif
+        if (idx != padded_block_size)
+            // The match might be in the padding.
+            return idx < std::size_t(end - cur) ? cur + idx : end;
+    }
+    return end;
+}
+
+// Same as above, but the input ends at the first byte equal to `Terminator` instead of end, where it
+// stops as well. It can read up to `padded_block_size` bytes past the terminator.
+template <typename Class, bool Negate, unsigned char Terminator>
+const unsigned char* byte_class_find_terminated(const unsigned char* cur) noexcept
+{
+    using block      = _byte_class_block<Class, Negate>;
+    using terminator = _byte_class_block<byte_set<Terminator>, false>;
+    auto min         = [](std::size_t a, std::size_t b) { return a < b ? a : b; };
+
+    // Every block starts at or before the terminator, so it doesn't exceed the padding.
+    for (;; cur += padded_block_size)
+    {
+#if LEXY_HAS_AVX2
+        auto idx = min(block::avx2(cur), terminator::avx2(cur));
+#elif LEXY_HAS_SSE2
+        auto idx = min(block::sse2(cur), terminator::sse2(cur));
+#else
+        auto idx = min(block::swar(cur), terminator::swar(cur));
+#endif
+        if (idx != padded_block_size)
+            return cur + idx;
+    }
+}
+
+template <typename... Ranges>
+const unsigned char* byte_class<Ranges...>::find(const unsigned char* cur,
+                                                 const unsigned char* end) noexcept
+{
+    return _byte_class_find<byte_class, false>(cur, end);
+}
+template <typename... Ranges>
+const unsigned char* byte_class<Ranges...>::find_not(const unsigned char* cur,
+                                                     const unsigned char* end) noexcept
+{
+    return _byte_class_find<byte_class, true>(cur, end);
+}
+template <typename... Ranges>
+const unsigned char* byte_class<Ranges...>::find_padded(const unsigned char* cur,
+                                                        const unsigned char* end) noexcept
+{
+    return _byte_class_find_padded<byte_class, false>(cur, end);
+}
+template <typename... Ranges>
+const unsigned char* byte_class<Ranges...>::find_not_padded(const unsigned char* cur,
+                                                            const unsigned char* end) noexcept
+{
+    return _byte_class_find_padded<byte_class, true>(cur, end);
+}
+
+/// Maps each byte to a bit mask of the classes that contain it, where void contains every byte.
+template <typename... Classes>
+struct byte_dispatch_table
+{
+    static_assert(sizeof...(Classes) <= 64);
+
+    std::uint_least64_t masks[256];
+
+    static constexpr byte_dispatch_table get()
+    {
+        byte_dispatch_table result{};
+        auto                idx = std::size_t(0);
+        (result._insert<Classes>(idx++), ...);
+        return result;
+    }
+
+    template <typename Class>
+    constexpr void _insert(std::size_t idx)
+    {
+        for (auto c = 0; c != 256; ++c)
+        {
+            if constexpr (!std::is_void_v<Class>)
+                if (!Class::contains(static_cast<unsigned char>(c)))
+                    continue;
+
+            masks[c] |= std::uint_least64_t(1) << idx;
+        }
+    }
+};
+
+template <typename... Classes>
+constexpr auto byte_dispatch_table_of = byte_dispatch_table<Classes...>::get();
+
+/// Finds the first position where the byte is in First and the next byte in Second.
+/// The last byte in the range is a candidate if it is in First.
+template <typename First, typename Second>
+struct byte_pair_scanner
+{
+    using first_class = First;
+
+    static const unsigned char* find(const unsigned char* cur, const unsigned char* end) noexcept
+    {
+#if LEXY_HAS_AVX2
+        for (; end - cur >= 33; cur += 32)
+        {
+            auto first  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+            auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + 1));
+            auto match  = _mm256_and_si256(First::avx2(first), Second::avx2(second));
+            if (auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(match)))
+                return cur + countr_zero(bits);
+        }
+#endif
+#if LEXY_HAS_SSE2
+        for (; end - cur >= 17; cur += 16)
+        {
+            auto first  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + 1));
+            auto match  = _mm_and_si128(First::sse2(first), Second::sse2(second));
+            if (auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(match)))
+                return cur + countr_zero(bits);
+        }
+#endif
+        for (; end - cur >= 9; cur += 8)
+        {
+            auto match = First::swar(swar_load(cur)) & Second::swar(swar_load(cur + 1));
+            if (match)
+                return cur + swar_first_byte(match);
+        }
+
+        for (; cur != end; ++cur)
+            if (First::contains(*cur) && (cur + 1 == end || Second::contains(cur[1])))
+                return cur;
+        return cur;
+    }
+
+    /// Same as `find()`, but the input ends at the first byte equal to `Terminator` instead of end.
+    /// It can read up to `padded_block_size` bytes past the terminator.
+    template <unsigned char Terminator>
+    static const unsigned char* find_terminated(const unsigned char* cur) noexcept
+    {
+        using terminator = byte_set<Terminator>;
+
+        // Every block starts at or before the terminator, so it doesn't exceed the padding.
+        for (;; cur += padded_block_size)
+        {
+#if LEXY_HAS_AVX2
+            auto first  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+            auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + 1));
+            auto match  = _mm256_and_si256(First::avx2(first),
+                                           _mm256_or_si256(Second::avx2(second),
+                                                           terminator::avx2(second)));
+            match       = _mm256_or_si256(match, terminator::avx2(first));
+            if (auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(match)))
+                return cur + countr_zero(bits);
+#elif LEXY_HAS_SSE2
+            auto first  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + 1));
+            auto match
+                = _mm_and_si128(First::sse2(first),
+                                _mm_or_si128(Second::sse2(second), terminator::sse2(second)));
+            match = _mm_or_si128(match, terminator::sse2(first));
+            if (auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(match)))
+                return cur + countr_zero(bits);
+#else
+            auto first  = swar_load(cur);
+            auto second = swar_load(cur + 1);
+            auto match  = (First::swar(first) & (Second::swar(second) | terminator::swar(second)))
+                         | terminator::swar(first);
+            if (match)
+                return cur + swar_first_byte(match);
+#endif
+        }
+    }
+};
+} // namespace lexy::_detail
+
+//=== byte swap ===//
+namespace lexy::_detail
+{
+// Reverses the bytes of every Size byte element in the word.
+template <std::size_t Size>
+constexpr swar_int swar_byte_swap(swar_int word)
+{
+    static_assert(Size == 2 || Size == 4);
+
+    word = ((word & 0x00FF'00FF'00FF'00FF) << 8) | ((word >> 8) & 0x00FF'00FF'00FF'00FF);
+    if constexpr (Size == 4)
+        word = ((word & 0x0000'FFFF'0000'FFFF) << 16) | ((word >> 16) & 0x0000'FFFF'0000'FFFF);
+    return word;
+}
+
+/// Copies `count` elements of `Size` bytes, reversing the bytes of each one.
+/// This converts UTF-16 and UTF-32 code units between little and big endian.
+template <std::size_t Size>
+void byte_swap_copy(unsigned char* dest, const unsigned char* src, std::size_t count) noexcept
+{
+    static_assert(Size == 2 || Size == 4);
+    const auto end = src + count * Size;
+
+#if LEXY_HAS_SSSE3
+    // Shuffle mask that reverses every element, within each 16 byte lane.
+    const auto shuffle = Size == 2 ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12,
+                                                   15, 14)
+                                   : _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                                                   13, 12);
+#    if LEXY_HAS_AVX2
+    const auto shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+    for (; end - src >= 32; src += 32, dest += 32)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_shuffle_epi8(v, shuffle256));
+    }
+#    endif
+    for (; end - src >= 16; src += 16, dest += 16)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_shuffle_epi8(v, shuffle));
+    }
+#elif LEXY_HAS_SSE2
+    for (; end - src >= 16; src += 16, dest += 16)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        v      = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        if constexpr (Size == 4)
+            v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), v);
+    }
+#endif
+    for (; end - src >= 8; src += 8, dest += 8)
+    {
+        auto word = swar_byte_swap<Size>(swar_load(src));
+        std::memcpy(dest, &word, sizeof(word));
+    }
+
+    for (; src != end; src += Size, dest += Size)
+        for (auto i = 0u; i != Size; ++i)
+            dest[i] = src[Size - 1 - i];
+}
+
+/// Converts the leading ASCII code units of `Size` bytes in the given endianness to single bytes,
+/// which are written to dest unless it is null.
+/// It only processes whole blocks, so the code unit after them might still be ASCII.
+/// Returns the number of converted code units.
+template <std::size_t Size, bool BigEndian>
+std::size_t narrow_ascii(unsigned char* dest, const unsigned char* src, std::size_t count) noexcept
+{
+    static_assert(Size == 2 || Size == 4);
+    auto result = std::size_t(0);
+
+#if LEXY_HAS_SSE2 && LEXY_IS_LITTLE_ENDIAN
+    constexpr auto units = 16 / Size;
+    for (; count - result >= units; result += units, src += 16)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+
+        // We check the bits that must be zero for ASCII, then move the value into a single byte.
+        if constexpr (Size == 2)
+        {
+            auto mask = _mm_set1_epi16(static_cast<short>(BigEndian ? 0x80FF : 0xFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, mask), _mm_setzero_si128()))
+                != 0xFFFF)
+                break;
+
+            if (dest != nullptr)
+            {
+                if constexpr (BigEndian)
+                    v = _mm_srli_epi16(v, 8);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(v, v));
+                dest += units;
+            }
+        }
+        else
+        {
+            auto mask = _mm_set1_epi32(static_cast<int>(BigEndian ? 0x80FF'FFFFu : 0xFFFF'FF80u));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, mask), _mm_setzero_si128()))
+                != 0xFFFF)
+                break;
+
+            if (dest != nullptr)
+            {
+                if constexpr (BigEndian)
+                    v = _mm_srli_epi32(v, 24);
+                v          = _mm_packs_epi32(v, v);
+                auto bytes = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+                std::memcpy(dest, &bytes, units);
+                dest += units;
+            }
+        }
+    }
+#else
+    (void)dest;
+    (void)src;
+    (void)count;
+#endif
+
+    return result;
+}
+} // namespace lexy::_detail
+
+//=== UTF-8 ===//
+namespace lexy::_detail
+{
+/// The bytes that cannot start a UTF-8 code point: continuation bytes, overlong and out of range
+/// leads.
+using utf8_non_lead = byte_class<byte_range<0x80, 0xC1>, byte_range<0xF5, 0xFF>>;
+
+// Returns the length of the valid UTF-8 code point starting at `cur`, or zero if it is invalid.
+// If `end` is null, the input is terminated by a byte that isn't a continuation byte instead.
+inline std::size_t utf8_code_point_length(const unsigned char* cur,
+                                          const unsigned char* end) noexcept
+{
+    LEXY_PRECONDITION(cur != end);
+    // The continuation bytes are read in order, so we never read past the terminator.
+    auto has     = [&](std::ptrdiff_t size) { return end == nullptr || end - cur >= size; };
+    auto is_cont = [](unsigned char c) { return (c & 0xC0) == 0x80; };
+
+    auto lead = cur[0];
+    if (lead < 0x80)
+        return 1;
+    else if (lead < 0xC2)
+        return 0;
+    else if (lead < 0xE0)
+        return has(2) && is_cont(cur[1]) ? 2 : 0;
+    else if (lead < 0xF0)
+    {
+        if (!has(3) || !is_cont(cur[1]) || !is_cont(cur[2]))
+            return 0;
+        else if (lead == 0xE0 && cur[1] < 0xA0)
+            return 0; // Overlong.
+        else if (lead == 0xED && cur[1] >= 0xA0)
+            return 0; // Surrogate.
+        else
+            return 3;
+    }
+    else if (lead < 0xF5)
+    {
+        if (!has(4) || !is_cont(cur[1]) || !is_cont(cur[2]) || !is_cont(cur[3]))
+            return 0;
+        else if (lead == 0xF0 && cur[1] < 0x90)
+            return 0; // Overlong.
+        else if (lead == 0xF4 && cur[1] >= 0x90)
+            return 0; // Out of range.
+        else
+            return 4;
+    }
+    else
+        return 0;
+}
+
+#if LEXY_HAS_SSSE3
+// Whether the 16 bytes are valid UTF-8 continuing the previous 16 bytes, ignoring a code point that
+// is incomplete at the end.
+// This is the lookup algorithm of Keiser and Lemire, "Validating UTF-8 In Less Than One
+// Instruction Per Byte" (2021): every error can be detected by looking at the high nibble of a
+// byte, and the high and low nibble of the previous byte, except for missing continuation bytes of
+// three and four byte sequences, which are checked separately.
+inline bool utf8_validate16(__m128i input, __m128i prev) noexcept
+{
+    constexpr auto too_short      = 1 << 0; // 11______ 0_______ or 11______ 11______
+    constexpr auto too_long       = 1 << 1; // 0_______ 10______
+    constexpr auto overlong_3     = 1 << 2; // 11100000 100_____
+    constexpr auto too_large      = 1 << 3; // 11110100 1001____ and above
+    constexpr auto surrogate      = 1 << 4; // 11101101 101_____
+    constexpr auto overlong_2     = 1 << 5; // 1100000_ 10______
+    constexpr auto too_large_1000 = 1 << 6; // 11110101 1000____ and above
+    constexpr auto overlong_4     = 1 << 6; // 11110000 1000____
+    constexpr auto two_conts      = 1 << 7; // 10______ 10______
+    constexpr auto carry          = too_short | too_long | two_conts;
+
+    auto table = [](auto... values) { return _mm_setr_epi8(static_cast<char>(values)...); };
+    auto high_nibble
+        = [](__m128i v) { return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)); };
+
+    auto prev1 = _mm_alignr_epi8(input, prev, 15);
+
+    auto byte_1_high
+        = _mm_shuffle_epi8(table(too_long, too_long, too_long, too_long, too_long, too_long,
+                                 too_long, too_long, two_conts, two_conts, two_conts, two_conts,
+                                 too_short | overlong_2, too_short,
+                                 too_short | overlong_3 | surrogate,
+                                 too_short | too_large | too_large_1000 | overlong_4),
+                           high_nibble(prev1));
+    auto byte_1_low = _mm_shuffle_epi8(
+        table(carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+              carry | too_large, carry | too_large | too_large_1000,
+              carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+              carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+              carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+              carry | too_large | too_large_1000, carry | too_large | too_large_1000 | surrogate,
+              carry | too_large | too_large_1000, carry | too_large | too_large_1000),
+        _mm_and_si128(prev1, _mm_set1_epi8(0x0F)));
+    auto byte_2_high = _mm_shuffle_epi8(
+        table(too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+              too_short,
+              too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+              too_long | overlong_2 | two_conts | overlong_3 | too_large,
+              too_long | overlong_2 | two_conts | surrogate | too_large,
+              too_long | overlong_2 | two_conts | surrogate | too_large, too_short, too_short,
+              too_short, too_short),
+        high_nibble(input));
+    auto special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // The second and third byte after a three or four byte lead must be continuation bytes.
+    // `two_conts` has flagged them as error, so we need to undo that.
+    auto is_third  = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8(0xE0 - 0x80));
+    auto is_fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13),
+                                   _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    auto must_be_cont
+        = _mm_and_si128(_mm_or_si128(is_third, is_fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    auto error = _mm_xor_si128(must_be_cont, special);
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+#endif
+
+template <typename Stop>
+constexpr bool _utf8_stop_has_lead = [] {
+    for (auto c = 0x80; c <= 0xFF; ++c)
+        if (Stop::contains(static_cast<unsigned char>(c))
+            && !utf8_non_lead::contains(static_cast<unsigned char>(c)))
+            return true;
+    return false;
+}();
+
+#if LEXY_HAS_SSSE3
+// Validates blocks of mixed ASCII and non-ASCII characters starting at a lead byte, until a block
+// contains an error or an ASCII character in `Stop`, which must not contain lead bytes.
+// Returns the lead byte of the last code point of the valid blocks, as it might be incomplete, or
+// `cur` if there were none.
+// If `Terminated`, the input ends at the first 0xFF byte instead of end, and it can read up to 16
+// bytes past it.
+template <typename Stop, bool Terminated>
+const unsigned char* _utf8_skip_blocks(const unsigned char* cur, const unsigned char* end) noexcept
+{
+    auto block_begin = cur;
+    auto prev        = _mm_setzero_si128();
+    for (; Terminated || end - cur >= 16; cur += 16)
+    {
+        auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        // Only check the ASCII characters; the others are lead bytes which we've excluded from
+        // Stop, or continuation bytes.
+        auto stop = static_cast<unsigned>(_mm_movemask_epi8(Stop::sse2(input)))
+                    & ~static_cast<unsigned>(_mm_movemask_epi8(input));
+        if constexpr (Terminated)
+            // Every block starts at or before the terminator, so it doesn't exceed the padding.
+            stop |= static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(input, _mm_set1_epi8(static_cast<char>(0xFF)))));
+        if (stop != 0 || !utf8_validate16(input, prev))
+            break;
+        prev = input;
+    }
+    if (cur == block_begin)
+        return cur;
+
+    // Everything before the last code point has been validated, but it might be incomplete.
+    // As the blocks began with a lead byte, we will find its lead byte.
+    --cur;
+    while ((*cur & 0xC0) == 0x80)
+        --cur;
+    return cur;
+}
+#endif
+
+/// Returns the first position that does not start a valid UTF-8 code point, or starts a code point
+/// with a byte in `Stop`, which must include `utf8_non_lead`.
+template <typename Stop>
+const unsigned char* utf8_find(const unsigned char* cur, const unsigned char* end) noexcept
+{
+    // Stops at ASCII characters in Stop and at all other bytes.
+    using ascii_run_stop = byte_class_union<Stop, byte_class<byte_range<0x80, 0xFF>>>;
+
+    while (true)
+    {
+        // Skip ASCII characters in bulk.
+        cur = ascii_run_stop::find(cur, end);
+        if (cur == end || Stop::contains(*cur))
+            return cur;
+
+        // We're now at the lead byte of a code point.
+#if LEXY_HAS_SSSE3
+        if constexpr (!_utf8_stop_has_lead<Stop>)
+            if (auto next = _utf8_skip_blocks<Stop, false>(cur, end); next != cur)
+            {
+                cur = next;
+                continue;
+            }
+#endif
+
+        auto length = utf8_code_point_length(cur, end);
+        if (length == 0)
+            return cur;
+        cur += length;
+    }
+}
+
+/// Same as `utf8_find`, but the input ends at the first 0xFF byte instead of end.
+/// It can read up to `padded_block_size` bytes past it.
+template <typename Stop>
+const unsigned char* utf8_find_terminated(const unsigned char* cur) noexcept
+{
+    using ascii_run_stop = byte_class_union<Stop, byte_class<byte_range<0x80, 0xFF>>>;
+    static_assert(Stop::contains(0xFF));
+
+    while (true)
+    {
+        cur = byte_class_find_terminated<ascii_run_stop, false, 0xFF>(cur);
+        if (Stop::contains(*cur))
+            return cur;
+
+#if LEXY_HAS_SSSE3
+        if constexpr (!_utf8_stop_has_lead<Stop>)
+            if (auto next = _utf8_skip_blocks<Stop, true>(cur, nullptr); next != cur)
+            {
+                cur = next;
+                continue;
+            }
+#endif
+
+        auto length = utf8_code_point_length(cur, nullptr);
+        if (length == 0)
+            return cur;
+        cur += length;
+    }
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_SIMD_HPP_INCLUDED
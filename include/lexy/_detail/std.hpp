@@ -17,11 +17,22 @@ struct bidirectional_iterator_tag;
 _GLIBCXX_END_NAMESPACE_VERSION
 } // namespace std
 
+namespace __gnu_cxx
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+template <typename Iterator, typename Container>
+class __normal_iterator;
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
 #elif defined(_LIBCPP_VERSION)
 
 _LIBCPP_BEGIN_NAMESPACE_STD
 struct forward_iterator_tag;
 struct bidirectional_iterator_tag;
+
+template <class Iterator>
+class __wrap_iter;
 _LIBCPP_END_NAMESPACE_STD
 
 #else
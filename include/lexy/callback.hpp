@@ -197,6 +197,9 @@ struct _noop
         return *this;
     }
 
+    // It ignores the lexemes, so they can be forwarded in bulk.
+    using _concatenates_lexemes = std::true_type;
+
     template <typename... Args>
     constexpr void operator()(const Args&...) const
     {}
@@ -517,6 +520,9 @@ struct _as_string
 
         using return_type = String;
 
+        // Appending adjacent lexemes one by one is the same as appending them at once.
+        using _concatenates_lexemes = std::true_type;
+
         template <typename CharT>
         auto operator()(CharT c) -> decltype(_result.push_back(c))
         {
@@ -605,6 +611,10 @@ struct _int
 // A callback that takes an optional sign and an integer and produces the signed integer.
 template <typename T>
 constexpr auto as_integer = _int<T>{};
+
+// A callback that takes an optional sign and a floating point number and produces the signed number.
+template <typename T>
+constexpr auto as_float = _int<T>{};
 } // namespace lexy
 
 #endif // LEXY_CALLBACK_HPP_INCLUDED
@@ -0,0 +1,965 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_COMPACT_PARSE_TREE_HPP_INCLUDED
+#define LEXY_COMPACT_PARSE_TREE_HPP_INCLUDED
+
+#include <cstring>
+#include <lexy/parse_tree.hpp>
+
+//=== internal: pt_compact_node ===//
+namespace lexy::_detail
+{
+// A node of a compact parse tree.
+// Nodes are stored in pre-order, so the first child of a production is stored immediately
+// afterwards, and the next sibling of a node is stored after all of its descendants.
+struct pt_compact_node
+{
+    static constexpr std::uint_least16_t flag_production       = 0b001;
+    static constexpr std::uint_least16_t flag_token_production = 0b010;
+    static constexpr std::uint_least16_t flag_last_child       = 0b100;
+
+    // For a token, the offset of its beginning relative to the beginning of the input.
+    // For a production, the index of its parent.
+    std::uint_least32_t first;
+    // For a token, the length of its lexeme.
+    // For a production, the index after its last descendant.
+    std::uint_least32_t second;
+    // For a token, its kind; for a production, the index of its name.
+    std::uint_least16_t kind;
+    std::uint_least16_t flags;
+
+    static pt_compact_node token(std::uint_least32_t offset, std::uint_least32_t size,
+                                 std::uint_least16_t kind) noexcept
+    {
+        return {offset, size, kind, 0};
+    }
+    static pt_compact_node production(std::uint_least32_t parent, std::uint_least16_t name,
+                                      bool token_production) noexcept
+    {
+        auto flags = std::uint_least16_t(flag_production);
+        if (token_production)
+            flags |= flag_token_production;
+        return {parent, 0, name, flags};
+    }
+
+    bool is_token() const noexcept
+    {
+        return (flags & flag_production) == 0;
+    }
+    bool is_production() const noexcept
+    {
+        return (flags & flag_production) != 0;
+    }
+    bool is_token_production() const noexcept
+    {
+        return (flags & flag_token_production) != 0;
+    }
+    bool is_last_child() const noexcept
+    {
+        return (flags & flag_last_child) != 0;
+    }
+};
+static_assert(sizeof(pt_compact_node) == 12);
+
+// Stores the nodes of a compact parse tree in a single array, and interns the production names.
+template <typename MemoryResource>
+class pt_compact_buffer
+{
+    using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
+
+    // Start with a page worth of nodes.
+    static constexpr std::size_t initial_capacity = 4096 / sizeof(pt_compact_node);
+    static constexpr std::size_t initial_name_capacity = 16;
+
+public:
+    static constexpr auto npos = std::uint_least32_t(-1);
+
+    //=== constructors/destructors/assignment ===//
+    explicit constexpr pt_compact_buffer(MemoryResource* resource) noexcept
+    : _resource(resource), _nodes(nullptr), _size(0), _capacity(0), _names(nullptr),
+      _name_index(nullptr), _name_count(0), _name_capacity(0)
+    {}
+
+    pt_compact_buffer(pt_compact_buffer&& other) noexcept
+    : _resource(other._resource), _nodes(other._nodes), _size(other._size),
+      _capacity(other._capacity), _names(other._names), _name_index(other._name_index),
+      _name_count(other._name_count), _name_capacity(other._name_capacity)
+    {
+        other._nodes      = nullptr;
+        other._size       = other._capacity = 0;
+        other._names      = nullptr;
+        other._name_index = nullptr;
+        other._name_count = other._name_capacity = 0;
+    }
+
+    ~pt_compact_buffer() noexcept
+    {
+        if (_nodes)
+            _resource->deallocate(_nodes, _capacity * sizeof(pt_compact_node),
+                                  alignof(pt_compact_node));
+        if (_names)
+        {
+            _resource->deallocate(_names, _name_capacity * sizeof(const char*),
+                                  alignof(const char*));
+            _resource->deallocate(_name_index, 2 * _name_capacity * sizeof(std::uint_least16_t),
+                                  alignof(std::uint_least16_t));
+        }
+    }
+
+    pt_compact_buffer& operator=(pt_compact_buffer&& other) noexcept
+    {
+        lexy::_detail::swap(_resource, other._resource);
+        lexy::_detail::swap(_nodes, other._nodes);
+        lexy::_detail::swap(_size, other._size);
+        lexy::_detail::swap(_capacity, other._capacity);
+        lexy::_detail::swap(_names, other._names);
+        lexy::_detail::swap(_name_index, other._name_index);
+        lexy::_detail::swap(_name_count, other._name_count);
+        lexy::_detail::swap(_name_capacity, other._name_capacity);
+        return *this;
+    }
+
+    //=== nodes ===//
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    pt_compact_node& operator[](std::size_t idx) noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _nodes[idx];
+    }
+    const pt_compact_node& operator[](std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _nodes[idx];
+    }
+
+    std::uint_least32_t push_back(const pt_compact_node& node)
+    {
+        if (_size == _capacity)
+            grow();
+
+        LEXY_PRECONDITION(_size < npos);
+        _nodes[_size] = node;
+        return std::uint_least32_t(_size++);
+    }
+
+    // Destroys all nodes starting at the index, keeping the memory.
+    void truncate(std::size_t size) noexcept
+    {
+        LEXY_PRECONDITION(size <= _size);
+        _size = size;
+    }
+
+    // Destroys all nodes, keeping the memory.
+    // The interned names are kept as well, they are likely needed again.
+    void clear() noexcept
+    {
+        _size = 0;
+    }
+
+    //=== names ===//
+    std::uint_least16_t intern(const char* name)
+    {
+        if (_name_count == _name_capacity)
+            grow_names();
+
+        auto mask = 2 * _name_capacity - 1;
+        for (auto idx = hash(name) & mask;; idx = (idx + 1) & mask)
+        {
+            auto entry = _name_index[idx];
+            if (entry == 0)
+            {
+                // The name isn't interned yet, add it.
+                _names[_name_count] = name;
+                _name_index[idx]    = std::uint_least16_t(++_name_count);
+                return std::uint_least16_t(_name_count - 1);
+            }
+            else if (_names[entry - 1] == name)
+                return std::uint_least16_t(entry - 1);
+        }
+    }
+
+    const char* name(std::uint_least16_t id) const noexcept
+    {
+        LEXY_PRECONDITION(id < _name_count);
+        return _names[id];
+    }
+
+private:
+    void grow()
+    {
+        auto new_capacity = _capacity == 0 ? initial_capacity : 2 * _capacity;
+        auto new_nodes    = static_cast<pt_compact_node*>(
+            _resource->allocate(new_capacity * sizeof(pt_compact_node), alignof(pt_compact_node)));
+
+        if (_nodes)
+        {
+            std::memcpy(new_nodes, _nodes, _size * sizeof(pt_compact_node));
+            _resource->deallocate(_nodes, _capacity * sizeof(pt_compact_node),
+                                  alignof(pt_compact_node));
+        }
+
+        _nodes    = new_nodes;
+        _capacity = new_capacity;
+    }
+
+    static std::size_t hash(const char* name) noexcept
+    {
+        auto value = reinterpret_cast<std::uintptr_t>(name);
+        return std::size_t(value ^ (value >> 12));
+    }
+
+    void grow_names()
+    {
+        // The index uses a 16-bit entry with zero meaning empty.
+        LEXY_PRECONDITION(_name_count < UINT_LEAST16_MAX);
+
+        auto new_capacity = _name_capacity == 0 ? initial_name_capacity : 2 * _name_capacity;
+        auto new_names    = static_cast<const char**>(
+            _resource->allocate(new_capacity * sizeof(const char*), alignof(const char*)));
+        auto new_index = static_cast<std::uint_least16_t*>(
+            _resource->allocate(2 * new_capacity * sizeof(std::uint_least16_t),
+                                alignof(std::uint_least16_t)));
+        std::memset(new_index, 0, 2 * new_capacity * sizeof(std::uint_least16_t));
+
+        // Re-insert the existing names.
+        auto mask = 2 * new_capacity - 1;
+        for (auto id = std::size_t(0); id != _name_count; ++id)
+        {
+            new_names[id] = _names[id];
+
+            auto idx = hash(_names[id]) & mask;
+            while (new_index[idx] != 0)
+                idx = (idx + 1) & mask;
+            new_index[idx] = std::uint_least16_t(id + 1);
+        }
+
+        if (_names)
+        {
+            _resource->deallocate(_names, _name_capacity * sizeof(const char*),
+                                  alignof(const char*));
+            _resource->deallocate(_name_index, 2 * _name_capacity * sizeof(std::uint_least16_t),
+                                  alignof(std::uint_least16_t));
+        }
+
+        _names         = new_names;
+        _name_index    = new_index;
+        _name_capacity = new_capacity;
+    }
+
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+
+    pt_compact_node* _nodes;
+    std::size_t      _size, _capacity;
+
+    const char**         _names;
+    std::uint_least16_t* _name_index; // Twice the capacity of names.
+    std::size_t          _name_count, _name_capacity;
+};
+} // namespace lexy::_detail
+
+//=== compact_parse_tree ===//
+namespace lexy
+{
+/// A parse tree that stores 32-bit offsets into the input instead of iterators and pointers.
+template <typename Reader, typename TokenKind = void,
+          typename MemoryResource = _detail::default_memory_resource>
+class compact_parse_tree
+{
+    static_assert(std::is_pointer_v<typename Reader::iterator>,
+                  "compact_parse_tree requires a contiguous input");
+
+    using _buffer_t           = _detail::pt_compact_buffer<MemoryResource>;
+    static constexpr auto npos = _buffer_t::npos;
+
+public:
+    //=== construction ===//
+    class builder;
+
+    constexpr compact_parse_tree()
+    : compact_parse_tree(_detail::get_memory_resource<MemoryResource>())
+    {}
+    constexpr explicit compact_parse_tree(MemoryResource* resource) : _buffer(resource), _begin()
+    {}
+
+    //=== container access ===//
+    bool empty() const noexcept
+    {
+        return _buffer.size() == 0;
+    }
+
+    void clear() noexcept
+    {
+        _buffer.clear();
+    }
+
+    //=== node access ===//
+    class node;
+    class node_kind;
+
+    node root() const noexcept
+    {
+        LEXY_PRECONDITION(!empty());
+        return node(this, 0);
+    }
+
+    //=== traverse ===//
+    class traverse_range;
+
+    traverse_range traverse(const node& n) const noexcept
+    {
+        return traverse_range(n);
+    }
+    traverse_range traverse() const noexcept
+    {
+        if (empty())
+            return traverse_range();
+        else
+            return traverse_range(root());
+    }
+
+private:
+    std::uint_least32_t _first_child(std::uint_least32_t idx) const noexcept
+    {
+        auto& n = _buffer[idx];
+        if (n.is_production() && idx + 1 < n.second)
+            return idx + 1;
+        else
+            return npos;
+    }
+
+    std::uint_least32_t _next_sibling(std::uint_least32_t idx) const noexcept
+    {
+        auto& n = _buffer[idx];
+        if (n.is_last_child() || idx == 0)
+            return npos;
+        else if (n.is_token())
+            return idx + 1;
+        else
+            return n.second;
+    }
+
+    std::uint_least32_t _parent(std::uint_least32_t idx) const noexcept
+    {
+        if (_buffer[idx].is_production())
+            // Includes the root, which is its own parent.
+            return _buffer[idx].first;
+
+        // Tokens don't store their parent: find the closest production that precedes the token.
+        // Either it is the parent, or the parent is one of its ancestors, as nodes are stored in
+        // pre-order. This is always terminated by the root.
+        auto cur = idx - 1;
+        while (_buffer[cur].is_token())
+            --cur;
+        while (_buffer[cur].second <= idx)
+            cur = _buffer[cur].first;
+        return cur;
+    }
+
+    _buffer_t                 _buffer;
+    typename Reader::iterator _begin;
+};
+
+template <typename Input, typename TokenKind = void,
+          typename MemoryResource = _detail::default_memory_resource>
+using compact_parse_tree_for
+    = lexy::compact_parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>;
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class compact_parse_tree<Reader, TokenKind, MemoryResource>::builder
+{
+    struct state;
+
+public:
+    template <typename Production>
+    explicit builder(compact_parse_tree&& tree, Production production,
+                     typename Reader::iterator begin)
+    : _result(LEXY_MOV(tree)), _cur(_start_root(production, begin))
+    {}
+    template <typename Production>
+    explicit builder(Production production, typename Reader::iterator begin)
+    : builder(compact_parse_tree(), production, begin)
+    {}
+
+    using production_state = state;
+
+    template <typename Production>
+    auto start_production(Production production)
+    {
+        if constexpr (lexy::is_transparent_production<Production>)
+            // Don't need to add a new node for a transparent production.
+            return state();
+
+        // Allocate a node for the production; its children are allocated afterwards.
+        // If we backtrack, the buffer is truncated back to this node.
+        auto node = _result._buffer.push_back(_production_node(production));
+
+        // Subsequent insertions are to the new node, so update state and return old one.
+        auto old = _cur;
+        _cur     = state(node);
+        return old;
+    }
+
+    void token(token_kind<TokenKind> _kind, typename Reader::iterator begin,
+               typename Reader::iterator end)
+    {
+        if (begin == end)
+            // Don't add empty tokens to the tree.
+            return;
+
+        auto kind   = token_kind<TokenKind>::to_raw(_kind);
+        auto offset = std::size_t(begin - _result._begin);
+        LEXY_PRECONDITION(std::size_t(end - _result._begin) <= UINT_LEAST32_MAX);
+
+        if (_cur.last_child != npos && _result._buffer[_cur.prod].is_token_production())
+        {
+            auto& last = _result._buffer[_cur.last_child];
+            if (last.is_token() && last.kind == kind)
+            {
+                // We're having the same token again, merge with the previous one.
+                last.second = std::uint_least32_t(offset + std::size_t(end - begin) - last.first);
+                return;
+            }
+        }
+
+        // Allocate and append.
+        _cur.last_child = _result._buffer.push_back(
+            _detail::pt_compact_node::token(std::uint_least32_t(offset),
+                                            std::uint_least32_t(end - begin), kind));
+    }
+
+    void finish_production(state&& s)
+    {
+        if (s.prod == npos)
+            // We're finishing with a transparent production, do nothing.
+            return;
+
+        // We're done with the current production.
+        _cur.finish(_result._buffer, s.prod);
+        // Append to previous production.
+        s.last_child = _cur.prod;
+        // Continue with the previous production.
+        _cur = s;
+    }
+
+    void backtrack_production(state&& s)
+    {
+        if (s.prod == npos)
+            // We're backtracking a transparent production, do nothing.
+            return;
+
+        // Deallocate everything from the backtracked production.
+        // As it is the last node with all its descendants, this is exact.
+        _result._buffer.truncate(_cur.prod);
+        // Continue with previous production.
+        _cur = s;
+    }
+
+    compact_parse_tree finish() &&
+    {
+        LEXY_PRECONDITION(_cur.prod == 0);
+        // The root is its own parent.
+        _cur.finish(_result._buffer, 0);
+        return LEXY_MOV(_result);
+    }
+
+private:
+    template <typename Production>
+    std::uint_least32_t _start_root(Production production, typename Reader::iterator begin)
+    {
+        // Empty the initial parse tree.
+        _result._buffer.clear();
+        _result._begin = begin;
+
+        // Allocate a new root node and begin construction there.
+        return _result._buffer.push_back(_production_node(production));
+    }
+
+    template <typename Production>
+    _detail::pt_compact_node _production_node(Production)
+    {
+        // The parent is only filled in once the production is finished.
+        auto name = _result._buffer.intern(lexy::production_name<Production>());
+        return _detail::pt_compact_node::production(npos, name,
+                                                    lexy::is_token_production<Production>);
+    }
+
+    compact_parse_tree _result;
+    struct state
+    {
+        // The current production all tokens are appended to.
+        std::uint_least32_t prod = npos;
+        // The last child of the current production.
+        std::uint_least32_t last_child = npos;
+
+        state() = default;
+
+        explicit state(std::uint_least32_t prod) : prod(prod) {}
+
+        void finish(_buffer_t& buffer, std::uint_least32_t parent)
+        {
+            // All descendants of the production have been allocated.
+            buffer[prod].first  = parent;
+            buffer[prod].second = std::uint_least32_t(buffer.size());
+            if (last_child != npos)
+                buffer[last_child].flags |= _detail::pt_compact_node::flag_last_child;
+        }
+    } _cur;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class compact_parse_tree<Reader, TokenKind, MemoryResource>::node_kind
+{
+public:
+    bool is_token() const noexcept
+    {
+        return _get().is_token();
+    }
+    bool is_production() const noexcept
+    {
+        return _get().is_production();
+    }
+
+    bool is_root() const noexcept
+    {
+        return _idx == 0;
+    }
+    bool is_token_production() const noexcept
+    {
+        return _get().is_token_production();
+    }
+
+    const char* name() const noexcept
+    {
+        if (is_production())
+            return _tree->_buffer.name(_get().kind);
+        else
+            return token_kind<TokenKind>::from_raw(_get().kind).name();
+    }
+
+    friend bool operator==(node_kind lhs, node_kind rhs)
+    {
+        if (lhs.is_token() && rhs.is_token())
+            return lhs._get().kind == rhs._get().kind;
+        else
+            // See the `operator==` for productions for rationale why this works.
+            return lhs.name() == rhs.name();
+    }
+    friend bool operator!=(node_kind lhs, node_kind rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator==(node_kind nk, token_kind<TokenKind> tk)
+    {
+        if (nk.is_token())
+            return token_kind<TokenKind>::from_raw(nk._get().kind) == tk;
+        else
+            return false;
+    }
+    friend bool operator==(token_kind<TokenKind> tk, node_kind nk)
+    {
+        return nk == tk;
+    }
+    friend bool operator!=(node_kind nk, token_kind<TokenKind> tk)
+    {
+        return !(nk == tk);
+    }
+    friend bool operator!=(token_kind<TokenKind> tk, node_kind nk)
+    {
+        return !(nk == tk);
+    }
+
+    template <typename Production, typename = lexy::production_rule<Production>>
+    friend bool operator==(node_kind nk, Production)
+    {
+        // See the `operator==` for productions of `parse_tree` for rationale why this works.
+        return nk.is_production() && nk.name() == lexy::production_name<Production>();
+    }
+    template <typename Production, typename = lexy::production_rule<Production>>
+    friend bool operator==(Production p, node_kind nk)
+    {
+        return nk == p;
+    }
+    template <typename Production, typename = lexy::production_rule<Production>>
+    friend bool operator!=(node_kind nk, Production p)
+    {
+        return !(nk == p);
+    }
+    template <typename Production, typename = lexy::production_rule<Production>>
+    friend bool operator!=(Production p, node_kind nk)
+    {
+        return !(nk == p);
+    }
+
+private:
+    explicit node_kind(const compact_parse_tree* tree, std::uint_least32_t idx)
+    : _tree(tree), _idx(idx)
+    {}
+
+    const _detail::pt_compact_node& _get() const noexcept
+    {
+        return _tree->_buffer[_idx];
+    }
+
+    const compact_parse_tree* _tree;
+    std::uint_least32_t       _idx;
+
+    friend compact_parse_tree::node;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class compact_parse_tree<Reader, TokenKind, MemoryResource>::node
+{
+public:
+    const void* address() const noexcept
+    {
+        return &_tree->_buffer[_idx];
+    }
+
+    auto kind() const noexcept
+    {
+        return node_kind(_tree, _idx);
+    }
+
+    auto parent() const noexcept
+    {
+        return node(_tree, _tree->_parent(_idx));
+    }
+
+    class children_range
+    {
+    public:
+        class iterator;
+        struct sentinel : _detail::sentinel_base<sentinel, iterator>
+        {};
+
+        class iterator : public _detail::forward_iterator_base<iterator, node, node, void>
+        {
+        public:
+            iterator() noexcept : _tree(nullptr), _cur(npos) {}
+
+            node deref() const noexcept
+            {
+                LEXY_PRECONDITION(*this != sentinel{});
+                return node(_tree, _cur);
+            }
+
+            void increment() noexcept
+            {
+                LEXY_PRECONDITION(*this != sentinel{});
+                _cur = _tree->_next_sibling(_cur);
+            }
+
+            bool equal(iterator rhs) const noexcept
+            {
+                return _cur == rhs._cur;
+            }
+            bool is_end() const noexcept
+            {
+                return _cur == npos;
+            }
+
+        private:
+            explicit iterator(const compact_parse_tree* tree, std::uint_least32_t cur) noexcept
+            : _tree(tree), _cur(cur)
+            {}
+
+            const compact_parse_tree* _tree;
+            std::uint_least32_t       _cur;
+
+            friend children_range;
+        };
+
+        bool empty() const noexcept
+        {
+            return _begin == npos;
+        }
+
+        std::size_t size() const noexcept
+        {
+            auto result = std::size_t(0);
+            for (auto iter = begin(); iter != end(); ++iter)
+                ++result;
+            return result;
+        }
+
+        iterator begin() const noexcept
+        {
+            return iterator(_tree, _begin);
+        }
+        sentinel end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        explicit children_range(const compact_parse_tree* tree, std::uint_least32_t begin)
+        : _tree(tree), _begin(begin)
+        {}
+
+        const compact_parse_tree* _tree;
+        std::uint_least32_t       _begin;
+
+        friend node;
+    };
+
+    auto children() const noexcept
+    {
+        return children_range(_tree, _tree->_first_child(_idx));
+    }
+
+    class sibling_range
+    {
+    public:
+        class iterator : public _detail::forward_iterator_base<iterator, node, node, void>
+        {
+        public:
+            iterator() noexcept : _tree(nullptr), _cur(npos) {}
+
+            node deref() const noexcept
+            {
+                return node(_tree, _cur);
+            }
+
+            void increment() noexcept
+            {
+                if (_cur == 0)
+                    // The root doesn't have siblings.
+                    return;
+
+                auto next = _tree->_next_sibling(_cur);
+                if (next == npos)
+                    // We're the last child, go to the first child instead.
+                    _cur = _tree->_first_child(_tree->_parent(_cur));
+                else
+                    _cur = next;
+            }
+
+            bool equal(iterator rhs) const noexcept
+            {
+                return _cur == rhs._cur;
+            }
+
+        private:
+            explicit iterator(const compact_parse_tree* tree, std::uint_least32_t cur) noexcept
+            : _tree(tree), _cur(cur)
+            {}
+
+            const compact_parse_tree* _tree;
+            std::uint_least32_t       _cur;
+
+            friend sibling_range;
+        };
+
+        bool empty() const noexcept
+        {
+            return begin() == end();
+        }
+
+        iterator begin() const noexcept
+        {
+            // We begin with the next node after ours.
+            // If we don't have siblings, this is our node itself.
+            return ++iterator(_tree, _node);
+        }
+        iterator end() const noexcept
+        {
+            // We end when we're back at the node.
+            return iterator(_tree, _node);
+        }
+
+    private:
+        explicit sibling_range(const compact_parse_tree* tree, std::uint_least32_t node) noexcept
+        : _tree(tree), _node(node)
+        {}
+
+        const compact_parse_tree* _tree;
+        std::uint_least32_t       _node;
+
+        friend node;
+    };
+
+    auto siblings() const noexcept
+    {
+        return sibling_range(_tree, _idx);
+    }
+
+    bool is_last_child() const noexcept
+    {
+        return _tree->_buffer[_idx].is_last_child();
+    }
+
+    auto lexeme() const noexcept
+    {
+        auto& n = _tree->_buffer[_idx];
+        if (n.is_token())
+        {
+            auto begin = _tree->_begin + n.first;
+            return lexy::lexeme<Reader>(begin, begin + n.second);
+        }
+        else
+            return lexy::lexeme<Reader>();
+    }
+
+    auto token() const noexcept
+    {
+        LEXY_PRECONDITION(kind().is_token());
+
+        auto& n     = _tree->_buffer[_idx];
+        auto  begin = _tree->_begin + n.first;
+        auto  kind  = token_kind<TokenKind>::from_raw(n.kind);
+        return lexy::token<Reader, TokenKind>(kind, begin, begin + n.second);
+    }
+
+    friend bool operator==(node lhs, node rhs) noexcept
+    {
+        return lhs._tree == rhs._tree && lhs._idx == rhs._idx;
+    }
+    friend bool operator!=(node lhs, node rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    explicit node(const compact_parse_tree* tree, std::uint_least32_t idx) noexcept
+    : _tree(tree), _idx(idx)
+    {}
+
+    const compact_parse_tree* _tree;
+    std::uint_least32_t       _idx;
+
+    friend compact_parse_tree;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class compact_parse_tree<Reader, TokenKind, MemoryResource>::traverse_range
+{
+public:
+    struct _value_type
+    {
+        traverse_event           event;
+        compact_parse_tree::node node;
+    };
+
+    class iterator : public _detail::forward_iterator_base<iterator, _value_type, _value_type, void>
+    {
+    public:
+        iterator() noexcept : _tree(nullptr), _cur(npos), _exit(false) {}
+        iterator(traverse_event ev, node n) noexcept
+        : _tree(n._tree), _cur(n._idx), _exit(ev == traverse_event::exit)
+        {
+            LEXY_PRECONDITION(!n.kind().is_token() || ev == traverse_event::leaf);
+        }
+
+        _value_type deref() const noexcept
+        {
+            if (_tree->_buffer[_cur].is_token())
+                return {traverse_event::leaf, node(_tree, _cur)};
+            else if (_exit)
+                return {traverse_event::exit, node(_tree, _cur)};
+            else
+                return {traverse_event::enter, node(_tree, _cur)};
+        }
+
+        void increment() noexcept
+        {
+            if (_tree->_buffer[_cur].is_production() && !_exit)
+            {
+                // We're entering a production, continue with its first child or exit it.
+                auto child = _tree->_first_child(_cur);
+                if (child == npos)
+                    _exit = true;
+                else
+                    _cur = child;
+            }
+            else if (_cur == 0)
+            {
+                // We're exiting the root, which is the end.
+                _cur  = std::uint_least32_t(_tree->_buffer.size());
+                _exit = false;
+            }
+            else if (auto next = _tree->_next_sibling(_cur); next != npos)
+            {
+                // We're done with the node, continue with its sibling.
+                _cur  = next;
+                _exit = false;
+            }
+            else
+            {
+                // We're done with the last child, exit the parent.
+                _cur  = _tree->_parent(_cur);
+                _exit = true;
+            }
+        }
+
+        bool equal(iterator rhs) const noexcept
+        {
+            // We need to point to the same node and in the same role.
+            return _cur == rhs._cur && _exit == rhs._exit;
+        }
+
+    private:
+        const compact_parse_tree* _tree;
+        std::uint_least32_t       _cur;
+        bool                      _exit;
+    };
+
+    bool empty() const noexcept
+    {
+        return _begin == _end;
+    }
+
+    iterator begin() const noexcept
+    {
+        return _begin;
+    }
+
+    iterator end() const noexcept
+    {
+        return _end;
+    }
+
+private:
+    traverse_range() noexcept = default;
+    traverse_range(node n) noexcept
+    {
+        if (n.kind().is_token())
+        {
+            _begin = iterator(traverse_event::leaf, n);
+            _end   = _begin;
+            ++_end;
+        }
+        else
+        {
+            _begin = iterator(traverse_event::enter, n);
+            _end   = iterator(traverse_event::exit, n);
+            ++_end;
+        }
+    }
+
+    iterator _begin, _end;
+
+    friend compact_parse_tree;
+};
+} // namespace lexy
+
+//=== parse_as_tree ===//
+namespace lexy
+{
+template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
+          typename Callback>
+bool parse_as_tree(compact_parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>& tree,
+                   const Input& input, Callback callback)
+{
+    return _parse_as_tree<Production>(tree, input, LEXY_MOV(callback));
+}
+} // namespace lexy
+
+#endif // LEXY_COMPACT_PARSE_TREE_HPP_INCLUDED
+
@@ -6,6 +6,7 @@
 #define LEXY_DSL_ALTERNATIVE_HPP_INCLUDED
 
 #include <lexy/_detail/detect.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/token.hpp>
 #include <lexy/engine/trie.hpp>
@@ -43,6 +44,15 @@ struct _trie : token_base<_trie<Strings...>>
     }
 };
 
+template <typename... Engines>
+constexpr auto _alt_scanner()
+{
+    if constexpr ((std::is_void_v<lexy::_engine_first_class<Engines>> || ...))
+        return;
+    else
+        return lexy::_detail::byte_class_union<lexy::_engine_first_class<Engines>...>{};
+}
+
 template <typename... Tokens>
 struct _alt : token_base<_alt<Tokens...>>
 {
@@ -53,13 +63,36 @@ struct _alt : token_base<_alt<Tokens...>>
             error = 1
         };
 
+        using _scanner = decltype(_alt_scanner<typename Tokens::token_engine...>());
+
+        // We dispatch on the first byte if at least one alternative can be ruled out that way.
+        static constexpr bool _use_dispatch
+            = sizeof...(Tokens) <= 64
+              && (!std::is_void_v<lexy::_engine_first_class<typename Tokens::token_engine>> || ...);
+
+        template <typename Reader, std::size_t... Idx>
+        static constexpr bool _dispatch(Reader& reader, lexy::_detail::index_sequence<Idx...>)
+        {
+            // Only try the alternatives that can start with the current byte.
+            // They're still tried in order, so the result is the same.
+            constexpr auto& table = lexy::_detail::byte_dispatch_table_of<
+                lexy::_engine_first_class<typename Tokens::token_engine>...>;
+            auto candidates = table.masks[lexy::_engine_peek_byte(reader)];
+            return (((candidates & (std::uint_least64_t(1) << Idx)) != 0
+                     && lexy::engine_try_match<typename Tokens::token_engine>(reader))
+                    || ...);
+        }
+
         template <typename Reader>
         static constexpr error_code match(Reader& reader)
         {
-            if ((lexy::engine_try_match<typename Tokens::token_engine>(reader) || ...))
-                return error_code();
+            auto result = false;
+            if constexpr (_use_dispatch && lexy::_engine_is_byte_reader<Reader>)
+                result = _dispatch(reader, lexy::_detail::index_sequence_for<Tokens...>{});
             else
-                return error_code::error;
+                result = (lexy::engine_try_match<typename Tokens::token_engine>(reader) || ...);
+
+            return result ? error_code() : error_code::error;
         }
     };
 
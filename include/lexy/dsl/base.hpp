@@ -7,6 +7,7 @@
 
 #include <lexy/_detail/assert.hpp>
 #include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
 #include <lexy/_detail/lazy_init.hpp>
 #include <lexy/engine/base.hpp>
 #include <lexy/input/base.hpp>
@@ -100,6 +101,35 @@ constexpr bool is_branch = [] {
 
 template <typename Rule, typename NextParser>
 using rule_parser = typename Rule::template parser<NextParser>;
+
+// A branch can provide a `_first_class`, which is either void or a `_detail::byte_class` that
+// contains the next byte whenever the branch is taken. For tokens, it is given by the engine.
+template <typename Rule>
+using _detect_branch_first_class = typename Rule::_first_class;
+
+template <typename T>
+constexpr auto _value_or_void()
+{
+    if constexpr (!std::is_void_v<T>)
+        return T{};
+}
+
+template <typename Rule>
+constexpr auto _branch_first_class_impl()
+{
+    if constexpr (!is_branch<Rule>)
+        return;
+    else if constexpr (Rule::is_unconditional_branch)
+        return;
+    else if constexpr (is_token<Rule>)
+        return _value_or_void<_engine_first_class<typename Rule::token_engine>>();
+    else if constexpr (_detail::is_detected<_detect_branch_first_class, Rule>)
+        return _value_or_void<typename Rule::_first_class>();
+}
+
+/// The `_detail::byte_class` of all bytes a branch can be taken on, or void if unknown.
+template <typename Rule>
+using _branch_first_class = decltype(_branch_first_class_impl<Rule>());
 } // namespace lexy
 
 namespace lexy
@@ -350,6 +380,20 @@ template <typename Production, typename Handler, typename Iterator>
 parse_context(Production p, Handler& handler, Iterator position)
     -> parse_context<Production, Handler, decltype(handler.start_production(p, position))>;
 
+template <typename Handler>
+using _detect_ignores_tokens = decltype(Handler::ignores_tokens);
+
+// Whether the handler of the context discards all tokens.
+// Only then may a rule report a different number of tokens, e.g. as an optimization.
+template <typename Context>
+constexpr bool _context_ignores_tokens = [] {
+    using handler = std::remove_reference_t<decltype(LEXY_DECLVAL(Context&).handler())>;
+    if constexpr (lexy::_detail::is_detected<_detect_ignores_tokens, handler>)
+        return handler::ignores_tokens;
+    else
+        return false;
+}();
+
 /// A final parser that forwards all elements to the context.
 struct context_value_parser
 {
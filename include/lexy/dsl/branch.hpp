@@ -18,6 +18,8 @@ struct _br : rule_base
     static constexpr auto is_branch               = true;
     static constexpr auto is_unconditional_branch = Condition::is_unconditional_branch;
 
+    using _first_class = lexy::_branch_first_class<Condition>;
+
     // We simple connect Condition with R... and then NextParser.
     // Condition has a try_parse() that will try to match Condition and then continue on with the
     // continuation.
@@ -5,6 +5,8 @@
 #ifndef LEXY_DSL_CHOICE_HPP_INCLUDED
 #define LEXY_DSL_CHOICE_HPP_INCLUDED
 
+#include <cstdint>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/branch.hpp>
 #include <lexy/error.hpp>
@@ -22,36 +24,48 @@ struct exhausted_choice
 
 namespace lexyd
 {
-template <typename NextParser, typename... R>
-struct _chc_parser;
-template <typename NextParser>
-struct _chc_parser<NextParser>
+// Only the branches whose bit is set in the candidate mask are tried.
+// Unconditional branches and branch indices beyond the size of the mask are always tried.
+template <typename NextParser, std::size_t Idx, typename... R>
+struct _chc_impl;
+template <typename NextParser, std::size_t Idx>
+struct _chc_impl<NextParser, Idx>
 {
     template <typename Context, typename Reader, typename... Args>
-    LEXY_DSL_FUNC bool parse(Context& context, Reader& reader, Args&&...)
+    LEXY_DSL_FUNC bool parse(std::uint_least64_t, Context& context, Reader& reader, Args&&...)
     {
         auto err = lexy::make_error<Reader, lexy::exhausted_choice>(reader.cur());
         context.error(err);
         return false;
     }
 };
-template <typename NextParser, typename H, typename... T>
-struct _chc_parser<NextParser, H, T...>
+template <typename NextParser, std::size_t Idx, typename H, typename... T>
+struct _chc_impl<NextParser, Idx, H, T...>
 {
     template <typename Context, typename Reader, typename... Args>
-    LEXY_DSL_FUNC bool parse(Context& context, Reader& reader, Args&&... args)
+    LEXY_DSL_FUNC bool parse(std::uint_least64_t candidates, Context& context, Reader& reader,
+                             Args&&... args)
     {
+        using next = _chc_impl<NextParser, Idx + 1, T...>;
+
         if constexpr (H::is_unconditional_branch)
         {
             return lexy::rule_parser<H, NextParser>::parse(context, reader, LEXY_FWD(args)...);
         }
         else
         {
+            if constexpr (Idx < 64)
+            {
+                if ((candidates & (std::uint_least64_t(1) << Idx)) == 0)
+                    // The branch can't be taken on the current input.
+                    return next::parse(candidates, context, reader, LEXY_FWD(args)...);
+            }
+
             auto result
                 = lexy::rule_parser<H, NextParser>::try_parse(context, reader, LEXY_FWD(args)...);
             if (result == lexy::rule_try_parse_result::backtracked)
                 // Try the next branch.
-                return _chc_parser<NextParser, T...>::parse(context, reader, LEXY_FWD(args)...);
+                return next::parse(candidates, context, reader, LEXY_FWD(args)...);
             else
                 // Return true/false depending on result.
                 return static_cast<bool>(result);
@@ -59,6 +73,35 @@ struct _chc_parser<NextParser, H, T...>
     }
 };
 
+template <typename NextParser, typename... R>
+struct _chc_parser
+{
+    // We dispatch on the next byte if at least one branch can be ruled out that way.
+    static constexpr bool _use_dispatch
+        = sizeof...(R) <= 64 && (!std::is_void_v<lexy::_branch_first_class<R>> || ...);
+
+    template <typename Context, typename Reader, typename... Args>
+    LEXY_DSL_FUNC bool parse(Context& context, Reader& reader, Args&&... args)
+    {
+        using impl = _chc_impl<NextParser, 0, R...>;
+
+        if constexpr (_use_dispatch && lexy::_engine_is_byte_reader<Reader>)
+        {
+            // Look up the branches that can start with the next byte.
+            // They are still tried in order, so branches with overlapping first bytes or unknown
+            // ones are handled as before.
+            constexpr auto& table
+                = lexy::_detail::byte_dispatch_table_of<lexy::_branch_first_class<R>...>;
+            auto candidates = table.masks[lexy::_engine_peek_byte(reader)];
+            return impl::parse(candidates, context, reader, LEXY_FWD(args)...);
+        }
+        else
+        {
+            return impl::parse(~std::uint_least64_t(0), context, reader, LEXY_FWD(args)...);
+        }
+    }
+};
+
 template <typename... R>
 struct _chc : rule_base
 {
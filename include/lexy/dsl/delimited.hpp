@@ -29,6 +29,66 @@ struct missing_delimiter
 
 namespace lexyd
 {
+// The bytes where the delimited content might end or an escape sequence might start, or void if
+// unknown.
+template <typename Close, typename Escape>
+constexpr auto _del_stop()
+{
+    using close_class = lexy::_branch_first_class<Close>;
+    if constexpr (std::is_void_v<close_class>)
+        return;
+    else if constexpr (std::is_void_v<Escape>)
+        return close_class{};
+    else if constexpr (std::is_void_v<lexy::_branch_first_class<Escape>>)
+        return;
+    else
+        return lexy::_detail::byte_class_union<close_class, lexy::_branch_first_class<Escape>>{};
+}
+
+template <typename Sink>
+using _detect_concatenating_sink = typename Sink::_concatenates_lexemes;
+
+// Whether the sink only concatenates the lexemes it receives, or ignores them.
+// Only then may adjacent lexemes be forwarded as a single one.
+// Sinks opt in by declaring `using _concatenates_lexemes = std::true_type;`.
+template <typename Sink>
+constexpr bool _sink_concatenates_lexemes = [] {
+    if constexpr (lexy::_detail::is_detected<_detect_concatenating_sink, Sink>)
+        return Sink::_concatenates_lexemes::value;
+    else
+        return false;
+}();
+
+// Consumes characters in bulk until the closing delimiter or escape sequence might start,
+// and forwards them to the sink as a single lexeme.
+// Returns false if it didn't consume anything.
+template <typename Char, typename Stop, typename Context, typename Reader, typename Sink>
+constexpr bool _del_skip(Context&, Reader& reader, Sink& sink)
+{
+    using engine = typename Char::token_engine;
+    // Tokens and lexemes are reported per character, so we can only do it if nobody observes them.
+    if constexpr (!std::is_void_v<Stop> && lexy::_engine_can_skip_utf8<engine, Reader>
+                  && lexy::_context_ignores_tokens<Context> && _sink_concatenates_lexemes<Sink>)
+    {
+        if (lexy::_detail::is_constant_evaluated())
+            return false;
+
+        auto content_begin = reader.cur();
+        lexy::_engine_skip_utf8<engine, Stop>(reader);
+        auto content_end = reader.cur();
+        if (content_begin == content_end)
+            return false;
+
+        sink(lexy::lexeme<Reader>(content_begin, content_end));
+        return true;
+    }
+    else
+    {
+        (void)reader, (void)sink;
+        return false;
+    }
+}
+
 template <typename Close, typename Char, typename Escape>
 struct _del : rule_base
 {
@@ -68,6 +128,10 @@ struct _del : rule_base
                     if (result == lexy::rule_try_parse_result::canceled)
                         return false;
                 }
+                // Parse a run of characters at once.
+                else if (_del_skip<Char, decltype(_del_stop<Close, Escape>())>(context, reader,
+                                                                                sink))
+                {}
                 // Parse the next character.
                 else
                 {
@@ -131,6 +195,9 @@ struct _del<Close, Char, void>
                     context.error(err);
                     return false;
                 }
+                // Parse a run of characters at once.
+                else if (_del_skip<Char, decltype(_del_stop<Close, void>())>(context, reader, sink))
+                {}
                 // Parse the next character.
                 else
                 {
@@ -6,6 +6,7 @@
 #define LEXY_DSL_DIGIT_HPP_INCLUDED
 
 #include <lexy/_detail/ascii_table.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/literal.hpp>
 #include <lexy/dsl/token.hpp>
@@ -68,6 +69,12 @@ struct decimal
     {
         return static_cast<unsigned>(c) - '0';
     }
+
+    // Returns the value of eight digits, the first one in the least significant byte.
+    LEXY_DSL_FUNC std::uint_least32_t _swar_value8(lexy::_detail::swar_int word)
+    {
+        return lexy::_detail::swar_parse_decimal8(word);
+    }
 };
 
 struct hex_lower
@@ -92,6 +99,12 @@ struct hex_lower
         else
             return unsigned(-1);
     }
+
+    // Returns the value of eight digits, the first one in the least significant byte.
+    LEXY_DSL_FUNC std::uint_least32_t _swar_value8(lexy::_detail::swar_int word)
+    {
+        return lexy::_detail::swar_parse_hex8(word);
+    }
 };
 
 struct hex_upper
@@ -116,6 +129,12 @@ struct hex_upper
         else
             return unsigned(-1);
     }
+
+    // Returns the value of eight digits, the first one in the least significant byte.
+    LEXY_DSL_FUNC std::uint_least32_t _swar_value8(lexy::_detail::swar_int word)
+    {
+        return lexy::_detail::swar_parse_hex8(word);
+    }
 };
 
 struct hex
@@ -143,6 +162,12 @@ struct hex
         else
             return unsigned(-1);
     }
+
+    // Returns the value of eight digits, the first one in the least significant byte.
+    LEXY_DSL_FUNC std::uint_least32_t _swar_value8(lexy::_detail::swar_int word)
+    {
+        return lexy::_detail::swar_parse_hex8(word);
+    }
 };
 } // namespace lexyd
 
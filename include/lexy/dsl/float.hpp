@@ -0,0 +1,339 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_DSL_FLOAT_HPP_INCLUDED
+#define LEXY_DSL_FLOAT_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <lexy/_detail/float_conversion.hpp>
+#include <lexy/_detail/simd.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/integer.hpp>
+#include <lexy/dsl/token.hpp>
+#include <lexy/engine/digits.hpp>
+
+namespace lexy
+{
+struct float_overflow
+{
+    static LEXY_CONSTEVAL auto name()
+    {
+        return "float overflow";
+    }
+};
+} // namespace lexy
+
+namespace lexyd
+{
+// Matches `digits [. digits] [(e|E) [+|-] digits]`.
+struct _flt_token : token_base<_flt_token>
+{
+    struct token_engine : lexy::engine_matcher_base
+    {
+        using _digits    = lexy::engine_digits<decimal::digit_set>;
+        using error_code = typename _digits::error_code;
+
+        // Every match starts with a digit.
+        using _scanner = typename _digits::_scanner;
+
+        template <typename Reader>
+        static constexpr bool _try_match_char(Reader& reader, char c)
+        {
+            if (reader.peek() != lexy::_char_to_int_type<typename Reader::encoding>(c))
+                return false;
+
+            reader.bump();
+            return true;
+        }
+
+        template <typename Reader>
+        static constexpr error_code match(Reader& reader)
+        {
+            if (auto ec = _digits::match(reader); ec != error_code())
+                return ec;
+
+            if (_try_match_char(reader, '.'))
+            {
+                // A fraction needs at least one digit.
+                if (auto ec = _digits::match(reader); ec != error_code())
+                    return ec;
+            }
+
+            if (_try_match_char(reader, 'e') || _try_match_char(reader, 'E'))
+            {
+                if (!_try_match_char(reader, '-'))
+                    _try_match_char(reader, '+');
+
+                // An exponent needs at least one digit.
+                if (auto ec = _digits::match(reader); ec != error_code())
+                    return ec;
+            }
+
+            return error_code();
+        }
+    };
+
+    template <typename Context, typename Reader>
+    static constexpr void token_error(Context& context, const Reader&,
+                                      typename token_engine::error_code,
+                                      typename Reader::iterator pos)
+    {
+        auto err = lexy::make_error<Reader, lexy::expected_char_class>(pos, decimal::name());
+        context.error(err);
+    }
+};
+
+// Converts a literal matched by `_flt_token` into the nearest T.
+template <typename T>
+struct _float_parser
+{
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "only float and double are supported");
+
+    // The number of significant decimal digits that fit into the mantissa.
+    static constexpr auto max_mantissa_digits = 19;
+    // Enough significant decimal digits to round every possible value correctly.
+    static constexpr auto max_exact_digits = 768;
+
+    template <typename CharT>
+    static constexpr bool _is_digit(CharT c)
+    {
+        return CharT('0') <= c && c <= CharT('9');
+    }
+
+    template <typename Iterator>
+    static constexpr bool _is_char(Iterator cur, Iterator end, char c)
+    {
+        return cur != end && *cur == c;
+    }
+
+    // Adds eight digits at a time as long as they fit into the mantissa.
+    template <typename Iterator>
+    static void _add_digits8(Iterator& cur, Iterator end, std::uint64_t& mantissa, int& digit_count,
+                             std::int64_t& exponent, bool is_fraction) noexcept
+    {
+        if constexpr (std::is_pointer_v<Iterator> && sizeof(*cur) == 1)
+        {
+            // We only do it after leading zeroes have been skipped.
+            while (digit_count > 0 && digit_count + 8 <= max_mantissa_digits && end - cur >= 8)
+            {
+                auto word = lexy::_detail::swar_load_le(reinterpret_cast<const unsigned char*>(cur));
+                if (!lexy::_detail::swar_is_decimal8(word))
+                    break;
+
+                mantissa = mantissa * 100'000'000u + decimal::_swar_value8(word);
+                digit_count += 8;
+                if (is_fraction)
+                    exponent -= 8;
+                cur += 8;
+            }
+        }
+        else
+        {
+            (void)cur, (void)end, (void)mantissa, (void)digit_count, (void)exponent;
+            (void)is_fraction;
+        }
+    }
+
+    // Parses the explicit exponent, if there is one.
+    template <typename Iterator>
+    static constexpr std::int64_t _parse_exponent(Iterator& cur, Iterator end)
+    {
+        using traits = lexy::integer_traits<std::int64_t>;
+
+        if (!_is_char(cur, end, 'e') && !_is_char(cur, end, 'E'))
+            return 0;
+        ++cur;
+
+        auto negative = _is_char(cur, end, '-');
+        if (negative || _is_char(cur, end, '+'))
+            ++cur;
+
+        // Anything beyond that is zero or infinity anyway, so we can saturate.
+        constexpr auto max_exponent = std::int64_t(1) << 48;
+
+        auto result = std::int64_t(0);
+        for (; cur != end && _is_digit(*cur); ++cur)
+            if (result < max_exponent)
+                traits::template add_digit_unchecked<10>(result, decimal::value(*cur));
+        return negative ? -result : result;
+    }
+
+    // Converts the literal using `strtod()`; required if more than `max_mantissa_digits` are
+    // relevant.
+    template <typename Iterator>
+    static bool _parse_slow(T& result, Iterator cur, Iterator end) noexcept
+    {
+        // We copy the significant digits without decimal point followed by the adjusted exponent,
+        // so the result doesn't depend on the current locale.
+        char buffer[max_exact_digits + 32];
+        auto size     = 0;
+        auto exponent = std::int64_t(0);
+        // Whether we've dropped a non-zero digit.
+        auto sticky = false;
+
+        auto add_digit = [&](char c, bool is_fraction) {
+            if (size == 0 && c == '0')
+            {
+                if (is_fraction)
+                    --exponent;
+            }
+            else if (size < max_exact_digits)
+            {
+                buffer[size++] = c;
+                if (is_fraction)
+                    --exponent;
+            }
+            else
+            {
+                if (!is_fraction)
+                    ++exponent;
+                sticky |= c != '0';
+            }
+        };
+
+        for (; cur != end && _is_digit(*cur); ++cur)
+            add_digit(static_cast<char>(*cur), false);
+        if (_is_char(cur, end, '.'))
+            for (++cur; cur != end && _is_digit(*cur); ++cur)
+                add_digit(static_cast<char>(*cur), true);
+        exponent += _parse_exponent(cur, end);
+
+        if (size == 0)
+        {
+            result = T(0);
+            return true;
+        }
+        else if (sticky)
+        {
+            // Any digit represents the dropped ones for the purposes of rounding.
+            buffer[size++] = '1';
+            --exponent;
+        }
+
+        buffer[size++] = 'e';
+        if (exponent < 0)
+        {
+            buffer[size++] = '-';
+            exponent       = -exponent;
+        }
+        auto exponent_begin = size;
+        do
+        {
+            buffer[size++] = static_cast<char>('0' + exponent % 10);
+            exponent /= 10;
+        } while (exponent > 0);
+        for (auto lhs = exponent_begin, rhs = size - 1; lhs < rhs; ++lhs, --rhs)
+            lexy::_detail::swap(buffer[lhs], buffer[rhs]);
+        buffer[size] = '\0';
+
+        if constexpr (std::is_same_v<T, float>)
+            result = std::strtof(buffer, nullptr);
+        else
+            result = std::strtod(buffer, nullptr);
+        return result <= std::numeric_limits<T>::max();
+    }
+
+    template <typename Iterator>
+    static bool parse(T& result, Iterator begin, Iterator end)
+    {
+        using traits = lexy::integer_traits<std::uint64_t>;
+
+        auto mantissa    = std::uint64_t(0);
+        auto digit_count = 0;
+        auto exponent    = std::int64_t(0);
+        // Whether we've dropped a non-zero digit from the mantissa.
+        auto truncated = false;
+
+        auto cur = begin;
+        for (; cur != end && _is_digit(*cur); ++cur)
+        {
+            _add_digits8(cur, end, mantissa, digit_count, exponent, false);
+            if (cur == end || !_is_digit(*cur))
+                break;
+
+            auto digit = decimal::value(*cur);
+            if (digit_count == max_mantissa_digits)
+            {
+                ++exponent;
+                truncated |= digit != 0;
+            }
+            else if (digit_count > 0 || digit != 0)
+            {
+                traits::template add_digit_unchecked<10>(mantissa, digit);
+                ++digit_count;
+            }
+        }
+        if (_is_char(cur, end, '.'))
+        {
+            for (++cur; cur != end && _is_digit(*cur); ++cur)
+            {
+                _add_digits8(cur, end, mantissa, digit_count, exponent, true);
+                if (cur == end || !_is_digit(*cur))
+                    break;
+
+                auto digit = decimal::value(*cur);
+                if (digit_count == max_mantissa_digits)
+                    truncated |= digit != 0;
+                else
+                {
+                    if (digit_count > 0 || digit != 0)
+                    {
+                        traits::template add_digit_unchecked<10>(mantissa, digit);
+                        ++digit_count;
+                    }
+                    --exponent;
+                }
+            }
+        }
+        exponent += _parse_exponent(cur, end);
+
+        if (!truncated && lexy::_detail::clinger_fast_path(result, exponent, mantissa))
+            return true;
+
+        auto am = lexy::_detail::eisel_lemire<T>(exponent, mantissa);
+        if (truncated && am != lexy::_detail::eisel_lemire<T>(exponent, mantissa + 1))
+            // The dropped digits are relevant for rounding.
+            return _parse_slow(result, begin, end);
+        else if (lexy::_detail::is_infinite<T>(am))
+            return false;
+
+        result = lexy::_detail::make_float<T>(am);
+        return true;
+    }
+};
+
+// Continuation of float that converts the literal.
+template <typename T>
+struct _flt_p : rule_base
+{
+    template <typename NextParser>
+    struct parser
+    {
+        template <typename Context, typename Reader, typename Iterator, typename... Args>
+        LEXY_DSL_FUNC bool parse(Context& context, Reader& reader, Iterator begin, Args&&... args)
+        {
+            using error_type = lexy::error<typename Reader::canonical_reader, lexy::float_overflow>;
+
+            auto result = T(0);
+            if (_float_parser<T>::parse(result, begin, reader.cur()))
+                return NextParser::parse(context, reader, LEXY_FWD(args)..., result);
+            else
+            {
+                context.error(error_type(begin, reader.cur()));
+                return false;
+            }
+        }
+    };
+};
+
+/// Parses a decimal floating point literal into the nearest float or double.
+template <typename T>
+constexpr auto float_ = _int_c<_flt_token>{} + _flt_p<T>{};
+} // namespace lexyd
+
+#endif // LEXY_DSL_FLOAT_HPP_INCLUDED
@@ -8,6 +8,8 @@
 #include <limits>
 
 #include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/detect.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/digit.hpp>
 
@@ -190,6 +192,21 @@ struct _unbounded_integer_parser
     }
 };
 
+template <typename Base>
+using _detect_swar_value8 = decltype(Base::_swar_value8(lexy::_detail::swar_int()));
+
+// Whether we can convert eight digits at a time from the iterator into T.
+template <typename T, typename Base, typename Iterator>
+constexpr bool _can_parse_swar = [] {
+    if constexpr (!std::is_pointer_v<Iterator>)
+        return false;
+    else if constexpr (!lexy::_detail::is_detected<_detect_swar_value8, Base>)
+        return false;
+    else
+        return sizeof(std::remove_pointer_t<Iterator>) == 1 && std::is_integral_v<T>
+               && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(unsigned long long);
+}();
+
 // Parses T in the Base without checking for overflow.
 template <typename T, typename Base, bool AssumeOnlyDigits>
 struct _bounded_integer_parser
@@ -199,6 +216,53 @@ struct _bounded_integer_parser
 
     static constexpr auto radix = Base::radix;
 
+    // Requires that the range only contains digits.
+    template <typename CharT>
+    static bool _parse_swar(result_type& result, const CharT* first, const CharT* last) noexcept
+    {
+        using wide_t      = unsigned long long;
+        using wide_traits = lexy::integer_traits<wide_t>;
+
+        // We can parse that many digits without overflowing wide_t.
+        constexpr auto safe_digit_count = wide_traits::template max_digit_count<radix> - 1;
+        // The factor to shift the value by eight digits.
+        constexpr auto chunk_factor = [] {
+            auto factor = wide_t(1);
+            for (auto i = 0; i != 8; ++i)
+                factor *= radix;
+            return factor;
+        }();
+
+        auto cur = reinterpret_cast<const unsigned char*>(first);
+        auto end = reinterpret_cast<const unsigned char*>(last);
+
+        // Skip leading zeroes, so the number of digits determines whether it can fit.
+        while (cur != end && *cur == '0')
+            ++cur;
+        if (std::size_t(end - cur) > traits::template max_digit_count<radix>)
+            return false;
+
+        // Parse as many digits as we can without checking for overflow, eight at a time.
+        auto value    = wide_t(0);
+        auto safe_end = std::size_t(end - cur) > safe_digit_count ? cur + safe_digit_count : end;
+        for (; safe_end - cur >= 8; cur += 8)
+            value = value * chunk_factor + Base::_swar_value8(lexy::_detail::swar_load_le(cur));
+        for (; cur != safe_end; ++cur)
+            wide_traits::template add_digit_unchecked<radix>(value, Base::value(*cur));
+
+        // Parse the remaining digits, if any, while checking for overflow.
+        for (; cur != end; ++cur)
+            if (!wide_traits::template add_digit_checked<radix>(value, Base::value(*cur)))
+                return false;
+
+        // Check for overflow once at the end.
+        if (value > static_cast<wide_t>(std::numeric_limits<T>::max()))
+            return false;
+
+        result = static_cast<result_type>(value);
+        return true;
+    }
+
     template <typename Iterator>
     static constexpr unsigned find_digit(Iterator& cur, Iterator end)
     {
@@ -225,6 +289,12 @@ struct _bounded_integer_parser
         static_assert(max_digit_count > 1,
                       "integer must be able to store all possible digit values");
 
+        if constexpr (AssumeOnlyDigits && _can_parse_swar<T, Base, Iterator>)
+        {
+            if (!lexy::_detail::is_constant_evaluated())
+                return _parse_swar(result, cur, end);
+        }
+
         // Skip leading zeroes.
         while (true)
         {
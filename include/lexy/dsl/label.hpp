@@ -58,6 +58,8 @@ struct _labr : rule_base
     static constexpr auto is_branch               = Rule::is_branch;
     static constexpr auto is_unconditional_branch = Rule::is_unconditional_branch;
 
+    using _first_class = lexy::_branch_first_class<Rule>;
+
     template <typename NextParser>
     struct parser
     {
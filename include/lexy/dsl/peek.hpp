@@ -15,6 +15,9 @@ struct _peek : rule_base
 {
     static constexpr auto is_branch = true;
 
+    // We can only be taken if the engine matches.
+    using _first_class = std::conditional_t<Expected, lexy::_engine_first_class<Engine>, void>;
+
     template <typename NextParser>
     struct parser : NextParser // propagate parse
     {
@@ -93,6 +93,8 @@ struct _prd : rule_base
     static constexpr auto is_branch               = _rule::is_branch;
     static constexpr auto is_unconditional_branch = _rule::is_unconditional_branch;
 
+    using _first_class = lexy::_branch_first_class<_rule>;
+
     template <typename NextParser>
     using parser = _prd_parser<Production, _rule, NextParser>;
 
@@ -70,6 +70,13 @@ struct _seq_impl<H, T...>
     };
 };
 
+// The sequence is taken if the first token matches.
+template <typename H, typename... T>
+constexpr auto _seq_first_class(_seq_impl<H, T...>)
+{
+    return lexy::_value_or_void<lexy::_branch_first_class<H>>();
+}
+
 template <typename... R>
 struct _seq : rule_base
 {
@@ -78,6 +85,8 @@ struct _seq : rule_base
     static constexpr auto is_branch               = (lexy::is_token<R> && ...);
     static constexpr auto is_unconditional_branch = false;
 
+    using _first_class = decltype(_seq_first_class(_seq_impl<R...>{}));
+
     template <typename NextParser>
     using parser = lexy::rule_parser<_seq_impl<R...>, NextParser>;
 };
@@ -16,9 +16,29 @@ struct _whl : rule_base
     template <typename NextParser>
     struct parser
     {
+        template <typename Context, typename Reader>
+        static constexpr bool _can_skip_utf8()
+        {
+            // Matching in bulk would report a single token for the entire run.
+            if constexpr (lexy::is_token<Branch> && std::is_void_v<lexy::_ws_rule<Context>>
+                          && lexy::_context_ignores_tokens<Context>)
+                return lexy::_engine_can_skip_utf8<typename Branch::token_engine, Reader>;
+            else
+                return false;
+        }
+
         template <typename Context, typename Reader, typename... Args>
         LEXY_DSL_FUNC bool parse(Context& context, Reader& reader, Args&&... args)
         {
+            if constexpr (_can_skip_utf8<Context, Reader>())
+            {
+                if (!lexy::_detail::is_constant_evaluated())
+                {
+                    // Match the token on all valid code points in bulk.
+                    lexy::_engine_skip_utf8<typename Branch::token_engine, void>(reader);
+                }
+            }
+
             while (true)
             {
                 using branch_parser
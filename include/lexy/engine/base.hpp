@@ -7,6 +7,8 @@
 
 #include <lexy/_detail/assert.hpp>
 #include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/input/base.hpp>
 
 #if 0
@@ -94,5 +96,192 @@ constexpr bool engine_peek(Reader reader)
 }
 } // namespace lexy
 
+namespace lexy
+{
+// A matcher can provide a `_scanner`, which is either void or a type with a static function
+// `find(cur, end)`. Given a range of single byte code units, it returns the first position where the
+// matcher could succeed, or `end`. This allows skipping ahead on contiguous readers.
+template <typename Matcher>
+using _detect_engine_scanner = typename Matcher::_scanner;
+
+// A matcher that consumes exactly one code unit can provide a `_byte_class`, which is either void or
+// a `_detail::byte_class` of all the code units it accepts, assuming a single byte encoding.
+// This allows matching it repeatedly in bulk on contiguous readers.
+template <typename Matcher>
+using _detect_engine_byte_class = typename Matcher::_byte_class;
+
+// A matcher can provide a `_utf8_stop`, which is either void or a `_detail::byte_class` that
+// contains `_detail::utf8_non_lead`. On UTF-8 input, the matcher must consume every valid code point
+// whose lead byte is not in the class. This allows matching it repeatedly in bulk on contiguous
+// readers, validating the input as it goes.
+template <typename Matcher>
+using _detect_engine_utf8_stop = typename Matcher::_utf8_stop;
+
+template <template <typename...> typename Detector, typename Matcher, typename Reader>
+constexpr bool _engine_has_bulk_hook = [] {
+    if constexpr (!_detail::is_contiguous_byte_reader<Reader>
+                  && !_detail::is_sentinel_byte_reader<Reader>)
+        return false;
+    else if constexpr (!_detail::is_detected<Detector, Matcher>)
+        return false;
+    else
+        return !std::is_void_v<Detector<Matcher>>;
+}();
+
+template <typename Matcher, typename Reader>
+constexpr bool _engine_can_scan = _engine_has_bulk_hook<_detect_engine_scanner, Matcher, Reader>;
+template <typename Matcher, typename Reader>
+constexpr bool _engine_can_skip
+    = _engine_has_bulk_hook<_detect_engine_byte_class, Matcher, Reader>;
+
+template <typename Matcher, typename Reader>
+constexpr bool _engine_can_skip_utf8
+    = std::is_same_v<typename Reader::encoding, lexy::utf8_encoding>
+      && _engine_has_bulk_hook<_detect_engine_utf8_stop, Matcher, Reader>;
+
+template <template <typename...> typename Detector, typename Matcher>
+constexpr auto _engine_hook_impl()
+{
+    if constexpr (!_detail::is_detected<Detector, Matcher>)
+        return;
+    else if constexpr (std::is_void_v<Detector<Matcher>>)
+        return;
+    else
+        return Detector<Matcher>{};
+}
+
+/// The type provided by the hook of the matcher, or void if it doesn't have one.
+template <template <typename...> typename Detector, typename Matcher>
+using _engine_hook = decltype(_engine_hook_impl<Detector, Matcher>());
+
+// Calls `fn(begin, end)` on contiguous readers and `fn(begin)` on sentinel readers, where it must
+// stop at the sentinel, and advances the reader to the position it returns.
+template <typename Reader, typename Fn>
+void _engine_bulk_advance(Reader& reader, Fn fn) noexcept
+{
+    auto begin = reinterpret_cast<const unsigned char*>(reader._ptr());
+    if constexpr (_detail::is_sentinel_byte_reader<Reader>)
+    {
+        auto pos = fn(begin);
+        reader._seek(reader._ptr() + (pos - begin));
+    }
+    else
+    {
+        auto end = reinterpret_cast<const unsigned char*>(reader._limit());
+        auto pos = fn(begin, end);
+        reader._seek(reader._ptr() + (pos - begin));
+    }
+}
+
+/// The byte that ends the input of a sentinel reader.
+template <typename Reader>
+constexpr auto _engine_sentinel_byte = static_cast<unsigned char>(Reader::encoding::eof());
+
+// A scanner has a `first_class`, which is a `_detail::byte_class` containing the first byte of
+// every match.
+template <typename Matcher>
+constexpr auto _engine_first_class_impl()
+{
+    if constexpr (!_detail::is_detected<_detect_engine_scanner, Matcher>)
+        return;
+    else if constexpr (std::is_void_v<typename Matcher::_scanner>)
+        return;
+    else
+        return typename Matcher::_scanner::first_class{};
+}
+
+/// The `_detail::byte_class` of all bytes a match of `Matcher` can start with, or void if unknown.
+template <typename Matcher>
+using _engine_first_class = decltype(_engine_first_class_impl<Matcher>());
+
+/// Whether the code units of the reader are single bytes, so `_engine_first_class` applies to them.
+template <typename Reader>
+constexpr bool _engine_is_byte_reader
+    = sizeof(typename Reader::encoding::char_type) == 1
+      && std::is_integral_v<typename Reader::encoding::int_type>;
+
+// Returns the byte of the next code unit, which is unspecified at EOF.
+template <typename Reader>
+constexpr unsigned char _engine_peek_byte(const Reader& reader)
+{
+    static_assert(_engine_is_byte_reader<Reader>);
+    return static_cast<unsigned char>(reader.peek());
+}
+
+// Scanning a padded block might load the byte after it as well.
+static_assert(_detail::padded_block_size + 1 <= _detail::input_padding);
+
+template <typename Scanner>
+using _detect_padded_scanner = decltype(&Scanner::find_padded);
+template <typename Scanner>
+using _detect_terminated_scanner = decltype(&Scanner::template find_terminated<0>);
+
+// Advances the reader to the next position where `Matcher` could succeed.
+template <typename Matcher, typename Reader>
+void _engine_scan(Reader& reader) noexcept
+{
+    static_assert(_engine_can_scan<Matcher, Reader>);
+
+    using scanner = typename Matcher::_scanner;
+    if constexpr (_detail::is_sentinel_byte_reader<Reader>)
+    {
+        if constexpr (_detail::is_detected<_detect_terminated_scanner, scanner>)
+            _engine_bulk_advance(reader,
+                                 &scanner::template find_terminated<_engine_sentinel_byte<Reader>>);
+        else
+            // As we also need to find the sentinel, we can only look for the first byte.
+            _engine_bulk_advance(reader, &_detail::byte_class_find_terminated<
+                                             typename scanner::first_class, false,
+                                             _engine_sentinel_byte<Reader>>);
+    }
+    else if constexpr (_detail::is_padded_reader<Reader>
+                       && _detail::is_detected<_detect_padded_scanner, scanner>)
+        _engine_bulk_advance(reader, &scanner::find_padded);
+    else
+        _engine_bulk_advance(reader, &scanner::find);
+}
+
+// Advances the reader as long as `Matcher` succeeds.
+template <typename Matcher, typename Reader>
+void _engine_skip(Reader& reader) noexcept
+{
+    static_assert(_engine_can_skip<Matcher, Reader>);
+    if constexpr (_detail::is_sentinel_byte_reader<Reader>)
+        _engine_bulk_advance(reader, &_detail::byte_class_find_terminated<
+                                         typename Matcher::_byte_class, true,
+                                         _engine_sentinel_byte<Reader>>);
+    else if constexpr (_detail::is_padded_reader<Reader>)
+        _engine_bulk_advance(reader, &Matcher::_byte_class::find_not_padded);
+    else
+        _engine_bulk_advance(reader, &Matcher::_byte_class::find_not);
+}
+
+template <typename Matcher, typename Stop>
+constexpr auto _engine_utf8_stop_impl()
+{
+    if constexpr (std::is_void_v<Stop>)
+        return typename Matcher::_utf8_stop{};
+    else
+        return _detail::byte_class_union<typename Matcher::_utf8_stop, Stop>{};
+}
+
+// Advances the reader as long as `Matcher` succeeds on a code point whose lead byte is not in
+// `Stop`, or until the first invalid code point.
+// This is conservative: the matcher might succeed on the next code point as well.
+template <typename Matcher, typename Stop, typename Reader>
+void _engine_skip_utf8(Reader& reader) noexcept
+{
+    static_assert(_engine_can_skip_utf8<Matcher, Reader>);
+    using stop = decltype(_engine_utf8_stop_impl<Matcher, Stop>());
+    if constexpr (_detail::is_sentinel_byte_reader<Reader>)
+    {
+        static_assert(_engine_sentinel_byte<Reader> == 0xFF);
+        _engine_bulk_advance(reader, &_detail::utf8_find_terminated<stop>);
+    }
+    else
+        _engine_bulk_advance(reader, &_detail::utf8_find<stop>);
+}
+} // namespace lexy
+
 #endif // LEXY_ENGINE_BASE_HPP_INCLUDED
 
@@ -7,10 +7,22 @@
 
 #include <climits>
 #include <lexy/_detail/integer_sequence.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/engine/base.hpp>
 
 namespace lexy
 {
+template <auto Min, auto Max>
+constexpr auto _char_range_byte_class()
+{
+    // For ASCII characters, the byte and its integer value coincide for all single byte encodings.
+    if constexpr (0 <= static_cast<long long>(Min) && static_cast<long long>(Max) <= 0x7F)
+        return _detail::byte_class<
+            _detail::byte_range<static_cast<unsigned char>(Min), static_cast<unsigned char>(Max)>>{};
+    else
+        return;
+}
+
 /// Matches the inclusive range of characters (code units).
 template <auto Min, auto Max>
 struct engine_char_range : engine_matcher_base
@@ -20,6 +32,9 @@ struct engine_char_range : engine_matcher_base
         error = 1,
     };
 
+    using _byte_class = decltype(_char_range_byte_class<Min, Max>());
+    using _scanner    = _byte_class;
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
@@ -75,6 +90,15 @@ LEXY_CONSTEVAL auto _make_strie()
 template <typename String>
 constexpr auto shallow_trie = _make_strie<String>();
 
+template <const auto& STrie, std::size_t... Transitions>
+constexpr auto _strie_byte_class(lexy::_detail::index_sequence<Transitions...>)
+{
+    if constexpr (sizeof(STrie._transition[0]) != 1 || sizeof...(Transitions) == 0)
+        return;
+    else
+        return _detail::byte_set<static_cast<unsigned char>(STrie._transition[Transitions])...>{};
+}
+
 /// Matches one of the specified characters in the trie.
 template <const auto& STrie>
 struct engine_char_set : engine_matcher_base
@@ -84,6 +108,9 @@ struct engine_char_set : engine_matcher_base
         error = 1,
     };
 
+    using _byte_class = decltype(_strie_byte_class<STrie>(STrie.transition_sequence()));
+    using _scanner    = _byte_class;
+
     template <typename Reader, std::size_t... Transitions>
     static constexpr auto _transition(Reader& reader, lexy::_detail::index_sequence<Transitions...>)
     {
@@ -173,6 +200,56 @@ private:
     int_n _table[0x80];
 };
 
+struct _ascii_table_ranges
+{
+    static constexpr std::size_t max_count = 8;
+
+    unsigned char min[max_count];
+    unsigned char max[max_count];
+    std::size_t   count;
+};
+
+// Splits the characters of the categories into ranges.
+template <const auto& Table, std::size_t... Categories>
+constexpr auto _ascii_table_ranges_of = [] {
+    _ascii_table_ranges result{};
+
+    auto in_range = false;
+    for (auto c = 0; c <= 0x80; ++c)
+    {
+        auto contained = c < 0x80 && Table.template contains<default_encoding, Categories...>(c);
+        if (contained && !in_range)
+        {
+            if (result.count == _ascii_table_ranges::max_count)
+            {
+                // Too many ranges, we don't bother.
+                result.count = 0;
+                break;
+            }
+
+            result.min[result.count] = static_cast<unsigned char>(c);
+            in_range                 = true;
+        }
+        else if (!contained && in_range)
+        {
+            result.max[result.count] = static_cast<unsigned char>(c - 1);
+            ++result.count;
+            in_range = false;
+        }
+    }
+
+    return result;
+}();
+
+template <const auto& Ranges, std::size_t... Idx>
+constexpr auto _ascii_table_byte_class(lexy::_detail::index_sequence<Idx...>)
+{
+    if constexpr (sizeof...(Idx) == 0)
+        return;
+    else
+        return _detail::byte_class<_detail::byte_range<Ranges.min[Idx], Ranges.max[Idx]>...>{};
+}
+
 /// Matches one of the specified categories of the ASCII table.
 template <const auto& Table, std::size_t... Categories>
 struct engine_ascii_table : engine_matcher_base
@@ -184,6 +261,12 @@ struct engine_ascii_table : engine_matcher_base
         error = 1,
     };
 
+    static constexpr auto& _ranges = _ascii_table_ranges_of<Table, Categories...>;
+    using _byte_class
+        = decltype(_ascii_table_byte_class<_ascii_table_ranges_of<Table, Categories...>>(
+            lexy::_detail::make_index_sequence<_ranges.count>{}));
+    using _scanner    = _byte_class;
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
@@ -71,6 +71,9 @@ struct engine_cp_utf8 : engine_matcher_base, engine_parser_base
 
     using error_code = _cp_error_code;
 
+    // Every valid code point matches.
+    using _utf8_stop = _detail::utf8_non_lead;
+
     template <typename Reader>
     static constexpr code_point parse(error_code& ec, Reader& reader)
     {
@@ -320,6 +323,9 @@ struct engine_cp_auto : lexy::engine_matcher_base, lexy::engine_parser_base
 {
     using error_code = _cp_error_code;
 
+    // Only used for UTF-8 input.
+    using _utf8_stop = engine_cp_utf8::_utf8_stop;
+
     template <typename Reader>
     static constexpr code_point parse(error_code& ec, Reader& reader)
     {
@@ -6,6 +6,7 @@
 #define LEXY_ENGINE_DIGITS_HPP_INCLUDED
 
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/while.hpp>
 
 namespace lexy
 {
@@ -17,6 +18,9 @@ struct engine_digits : engine_matcher_base
 
     using error_code = typename DigitSet::error_code;
 
+    // Every match starts with a digit.
+    using _scanner = _engine_first_class<DigitSet>;
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
@@ -25,8 +29,7 @@ struct engine_digits : engine_matcher_base
             return ec;
 
         // Match subsequent digits as often as possible.
-        while (engine_try_match<DigitSet>(reader))
-        {}
+        engine_while<DigitSet>::match(reader);
 
         return error_code();
     }
@@ -40,6 +43,9 @@ struct engine_digits_sep : engine_matcher_base
 
     using error_code = typename DigitSet::error_code;
 
+    // Every match starts with a digit.
+    using _scanner = _engine_first_class<DigitSet>;
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
@@ -102,8 +108,7 @@ struct engine_digits_trimmed : engine_matcher_base
                 return translate(ec);
 
             // Match subsequent digits as often as possible.
-            while (engine_try_match<DigitSet>(reader))
-            {}
+            engine_while<DigitSet>::match(reader);
 
             return error_code();
         }
@@ -176,6 +181,9 @@ struct engine_ndigits : engine_matcher_base
 
     using error_code = typename DigitSet::error_code;
 
+    // Every match starts with a digit.
+    using _scanner = _engine_first_class<DigitSet>;
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
@@ -220,6 +228,9 @@ struct engine_ndigits_sep : engine_matcher_base
 
     using error_code = typename DigitSet::error_code;
 
+    // Every match starts with a digit.
+    using _scanner = _engine_first_class<DigitSet>;
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
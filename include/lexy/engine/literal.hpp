@@ -6,6 +6,7 @@
 #define LEXY_ENGINE_LITERAL_HPP_INCLUDED
 
 #include <lexy/_detail/integer_sequence.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/engine/base.hpp>
 
 namespace lexy
@@ -17,6 +18,10 @@ struct _ltrie
     {
         return NodeCount == 0;
     }
+    LEXY_CONSTEVAL std::size_t size() const
+    {
+        return NodeCount;
+    }
 
     LEXY_CONSTEVAL auto node_sequence() const
     {
@@ -50,6 +55,38 @@ LEXY_CONSTEVAL auto _make_ltrie()
 template <typename String>
 constexpr auto linear_trie = _make_ltrie<String>();
 
+template <const auto& LTrie>
+constexpr auto _ltrie_scanner()
+{
+    constexpr auto is_byte = sizeof(LTrie._transition[0]) == 1;
+    constexpr auto first   = static_cast<unsigned char>(LTrie._transition[0]);
+    constexpr auto second  = static_cast<unsigned char>(LTrie._transition[LTrie.size() > 1 ? 1 : 0]);
+
+    if constexpr (!is_byte || LTrie.empty())
+        return;
+    else if constexpr (LTrie.size() == 1)
+        return _detail::byte_set<first>{};
+    else
+        // We look for the first two characters at once, to reduce false positives.
+        return _detail::byte_pair_scanner<_detail::byte_set<first>, _detail::byte_set<second>>{};
+}
+
+template <const auto& LTrie>
+constexpr auto _make_ltrie_bytes()
+{
+    struct bytes_t
+    {
+        unsigned char data[LTrie.empty() ? 1 : LTrie.size()];
+    } result{};
+    for (auto idx = 0u; idx != LTrie.size(); ++idx)
+        result.data[idx] = static_cast<unsigned char>(LTrie._transition[idx]);
+    return result;
+}
+
+// The bytes of a linear trie of single byte characters.
+template <const auto& LTrie>
+constexpr auto _ltrie_bytes = _make_ltrie_bytes<LTrie>();
+
 /// Matches the linear trie.
 template <const auto& LTrie>
 struct engine_literal : engine_matcher_base
@@ -58,6 +95,10 @@ struct engine_literal : engine_matcher_base
     {
     };
 
+    using _scanner = decltype(_ltrie_scanner<LTrie>());
+    // A literal of a single byte matches exactly that code unit.
+    using _byte_class = std::conditional_t<LTrie.size() == 1, _scanner, void>;
+
     static LEXY_CONSTEVAL error_code index_to_error(std::size_t idx)
     {
         return error_code(idx + 1);
@@ -81,9 +122,51 @@ struct engine_literal : engine_matcher_base
         return result;
     }
 
+    // Whether we can compare the entire literal at once on the reader.
+    template <typename Reader>
+    static constexpr bool _compare_words = [] {
+        if constexpr (sizeof(LTrie._transition[0]) != 1 || LTrie.size() <= 1)
+            return false;
+        else if constexpr (_detail::is_contiguous_byte_reader<Reader>)
+            return true;
+        else if constexpr (_detail::is_sentinel_byte_reader<Reader>)
+        {
+            // We can read past the sentinel into the padding, as the comparison fails there as
+            // long as the literal doesn't contain the sentinel byte.
+            if (LTrie.size() > _detail::input_padding)
+                return false;
+            for (auto idx = 0u; idx != LTrie.size(); ++idx)
+                if (_ltrie_bytes<LTrie>.data[idx] == _engine_sentinel_byte<Reader>)
+                    return false;
+            return true;
+        }
+        else
+            return false;
+    }();
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
+        if constexpr (_compare_words<Reader>)
+        {
+            if (!_detail::is_constant_evaluated())
+            {
+                // Compare the entire literal at once.
+                // On mismatch, we fall back to the transitions to determine the error.
+                auto cur  = reinterpret_cast<const unsigned char*>(reader._ptr());
+                auto fits = true;
+                if constexpr (!_detail::is_sentinel_byte_reader<Reader>)
+                    fits = std::size_t(reinterpret_cast<const unsigned char*>(reader._limit())
+                                       - cur)
+                           >= LTrie.size();
+                if (fits && _detail::swar_equal<LTrie.size()>(cur, _ltrie_bytes<LTrie>.data))
+                {
+                    reader._seek(reader._ptr() + LTrie.size());
+                    return error_code();
+                }
+            }
+        }
+
         return _transition(reader, LTrie.node_sequence());
     }
 };
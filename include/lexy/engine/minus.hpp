@@ -9,6 +9,20 @@
 
 namespace lexy
 {
+template <typename Matcher, typename... Excepts>
+constexpr auto _minus_utf8_stop()
+{
+    using stop = _engine_hook<_detect_engine_utf8_stop, Matcher>;
+    if constexpr (std::is_void_v<stop>)
+        return;
+    else if constexpr ((std::is_void_v<_engine_hook<_detect_engine_byte_class, Excepts>> || ...))
+        return;
+    else
+        // An except that matches a single code unit can only exclude code points starting with it.
+        return _detail::byte_class_union<stop,
+                                         _engine_hook<_detect_engine_byte_class, Excepts>...>{};
+}
+
 /// Matches `Matcher` but only if none of the `Excepts` match the same input.
 template <typename Matcher, typename... Excepts>
 struct engine_minus : lexy::engine_matcher_base
@@ -20,6 +34,8 @@ struct engine_minus : lexy::engine_matcher_base
         minus_failure = 1,
     };
 
+    using _utf8_stop = decltype(_minus_utf8_stop<Matcher, Excepts...>());
+
     static constexpr error_code error_from_matcher(typename Matcher::error_code ec)
     {
         LEXY_PRECONDITION(ec != typename Matcher::error_code());
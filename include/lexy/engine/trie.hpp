@@ -6,6 +6,7 @@
 #define LEXY_ENGINE_TRIE_HPP_INCLUDED
 
 #include <lexy/_detail/integer_sequence.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/engine/base.hpp>
 
 namespace lexy
@@ -53,17 +54,31 @@ LEXY_CONSTEVAL auto _make_trie()
     // We can estimate the number of nodes in the trie by adding all strings together.
     // This is the worst case where the strings don't share any nodes.
     // The plus one comes from the additional root node.
-    constexpr auto node_count_upper_bound = (Strings::get().size() + ... + 1);
+    // (We don't use a fold expression as it would be nested too deeply for many strings.)
+    constexpr auto node_count_upper_bound = [] {
+        std::size_t sizes[] = {1, Strings::get().size()...};
+
+        auto result = std::size_t(0);
+        for (auto size : sizes)
+            result += size;
+        return result;
+    }();
 
     // We cannot construct the `_trie` directly as we don't know how many transitions each node has.
-    // So we use this temporary representation using an adjacency matrix.
+    // So we use this temporary representation where every node except the root is stored together
+    // with the transition leading to it, and the transitions of each node form a linked list.
+    // This keeps the size linear in the total length of all strings.
     struct builder_t
     {
         std::size_t node_count       = 1;
         std::size_t transition_count = 0;
 
-        bool  node_accept[node_count_upper_bound]                             = {};
-        CharT node_transition[node_count_upper_bound][node_count_upper_bound] = {};
+        bool  node_accept[node_count_upper_bound] = {};
+        CharT node_char[node_count_upper_bound]   = {};
+        // The nodes are linked by their index; zero is never a child and thus used as null.
+        std::size_t node_first_child[node_count_upper_bound]  = {};
+        std::size_t node_last_child[node_count_upper_bound]   = {};
+        std::size_t node_next_sibling[node_count_upper_bound] = {};
 
         constexpr void insert(const CharT* str, std::size_t size)
         {
@@ -73,28 +88,26 @@ LEXY_CONSTEVAL auto _make_trie()
                 auto c = *ptr;
                 LEXY_PRECONDITION(c);
 
-                auto found = false;
-                for (auto next_node = cur_node + 1; next_node < node_count; ++next_node)
-                {
-                    if (node_transition[cur_node][next_node] == c)
-                    {
-                        // The transition from `cur_node` to `next_node` using `c` is already in
-                        // the trie. Follow it.
-                        cur_node = next_node;
-                        found    = true;
-                        break;
-                    }
-                }
+                auto next_node = node_first_child[cur_node];
+                while (next_node != 0 && node_char[next_node] != c)
+                    next_node = node_next_sibling[next_node];
 
-                if (!found)
+                if (next_node == 0)
                 {
                     // We haven't found the transition, need to create a new node.
-                    auto next_node                       = node_count++;
-                    node_transition[cur_node][next_node] = c;
+                    // It is appended to the list of children, so they remain sorted by index.
+                    next_node            = node_count++;
+                    node_char[next_node] = c;
                     transition_count++;
 
-                    cur_node = next_node;
+                    if (node_first_child[cur_node] == 0)
+                        node_first_child[cur_node] = next_node;
+                    else
+                        node_next_sibling[node_last_child[cur_node]] = next_node;
+                    node_last_child[cur_node] = next_node;
                 }
+
+                cur_node = next_node;
             }
             node_accept[cur_node] = true;
         }
@@ -102,27 +115,28 @@ LEXY_CONSTEVAL auto _make_trie()
     // We build the trie by inserting all strings.
     constexpr auto builder = [] {
         builder_t builder;
-        (builder.insert(Strings::get().data(), Strings::get().size()), ...);
+        int       dummy[] = {0, (builder.insert(Strings::get().data(), Strings::get().size()), 0)...};
+        (void)dummy;
         return builder;
     }();
 
     // Now we also now the exact number of nodes and transitions in the trie.
     _trie<CharT, builder.node_count, builder.transition_count> result{};
 
-    // Translate the adjacency matrix representation into the actual trie representation.
+    // Translate the linked list representation into the actual trie representation.
     auto transition_idx = 0u;
     for (auto node = 0u; node != builder.node_count; ++node)
     {
         result._node_accept[node] = builder.node_accept[node];
 
-        for (auto next_node = node + 1; next_node != builder.node_count; ++next_node)
-            if (auto c = builder.node_transition[node][next_node])
-            {
-                // We've found a transition, add it to the shared transition array.
-                result._transition_char[transition_idx] = c;
-                result._transition_node[transition_idx] = next_node;
-                ++transition_idx;
-            }
+        for (auto next_node = builder.node_first_child[node]; next_node != 0;
+             next_node      = builder.node_next_sibling[next_node])
+        {
+            // We've found a transition, add it to the shared transition array.
+            result._transition_char[transition_idx] = builder.node_char[next_node];
+            result._transition_node[transition_idx] = next_node;
+            ++transition_idx;
+        }
 
         // The node transition end at the current transition index.
         result._node_transition_idx[node] = transition_idx;
@@ -135,8 +149,22 @@ LEXY_CONSTEVAL auto _make_trie()
 template <typename CharT, typename... Strings>
 constexpr auto trie = _make_trie<CharT, Strings...>();
 
+template <const auto& Trie, std::size_t... Transitions>
+constexpr auto _trie_scanner(lexy::_detail::index_sequence<Transitions...>)
+{
+    // If the root node accepts, we can match anywhere.
+    if constexpr (sizeof(Trie._transition_char[0]) != 1 || sizeof...(Transitions) == 0
+                  || Trie.node_accept(0))
+        return;
+    else
+        return _detail::byte_set<static_cast<unsigned char>(
+            Trie.transition_char(0, Transitions))...>{};
+}
+
 /// Matches one of the strings contained in the trie.
-template <const auto& Trie>
+/// Nodes with at least `TableThreshold` transitions use a lookup table instead of comparing each
+/// transition.
+template <const auto& Trie, std::size_t TableThreshold = 8>
 struct engine_trie : engine_matcher_base
 {
     enum class error_code
@@ -151,27 +179,89 @@ struct engine_trie : engine_matcher_base
     struct _node                              // Base case if we pass void as transitions.
     : _node<Node, _transition_sequence<Node>> // Compute transition and forward.
     {};
+
+    using _scanner = decltype(_trie_scanner<Trie>(_transition_sequence<0>{}));
+
+    // Maps the (unsigned) value of a code unit in [0, 256) to the transition index plus one.
+    // Zero means that there is no transition for that code unit.
+    template <std::size_t TransitionCount>
+    struct _node_table
+    {
+        using index_t = std::conditional_t<(TransitionCount < 0xFF), unsigned char, unsigned short>;
+
+        index_t next[256];
+        bool    valid;
+    };
+
     template <std::size_t Node, std::size_t... Transitions>
     struct _node<Node, lexy::_detail::index_sequence<Transitions...>>
     {
         template <std::size_t Transition>
         using transition = _node<Trie.transition_next(Node, Transition), void>;
 
+        template <typename Encoding>
+        using _key_t = std::make_unsigned_t<typename Encoding::int_type>;
+
+        template <typename Encoding>
+        static constexpr auto _table = [] {
+            using table_t = _node_table<sizeof...(Transitions)>;
+
+            table_t result{};
+            if constexpr (std::is_integral_v<typename Encoding::int_type>)
+            {
+                result.valid = true;
+                auto insert  = [&](std::size_t transition, auto key) {
+                    if (key < 256)
+                        result.next[key] = static_cast<typename table_t::index_t>(transition + 1);
+                    else
+                        // The code unit doesn't fit into the table.
+                        result.valid = false;
+                };
+                (insert(Transitions, static_cast<_key_t<Encoding>>(_char_to_int_type<Encoding>(
+                                         Trie.transition_char(Node, Transitions)))),
+                 ...);
+            }
+            return result;
+        }();
+
+        template <typename Encoding>
+        static constexpr bool _use_table
+            = sizeof...(Transitions) >= TableThreshold && _table<Encoding>.valid;
+
         template <typename Reader>
-        static constexpr auto match(Reader& reader)
+        static constexpr error_code match(Reader& reader)
         {
             using encoding = typename Reader::encoding;
             auto save      = reader;
             auto cur       = reader.peek();
 
             auto result = error_code::error;
-            // Check the character of each transition.
-            // If it matches, we advance by one and go to that node.
-            // As soon as we do that, we return true to short circuit the search.
-            (void)((cur == _char_to_int_type<encoding>(Trie.transition_char(Node, Transitions))
-                        ? (reader.bump(), result = transition<Transitions>::match(reader), true)
-                        : false)
-                   || ...);
+            if constexpr (_use_table<encoding>)
+            {
+                // Look up the transition in the table, and dispatch to the next node.
+                // The comparisons of the index against a dense range of constants are turned into a
+                // switch by the compiler, and each node can still be inlined.
+                auto key = static_cast<_key_t<encoding>>(cur);
+                if (key < 256)
+                    if (auto idx = std::size_t(_table<encoding>.next[key]))
+                    {
+                        reader.bump();
+                        (void)((idx == Transitions + 1
+                                    ? (result = transition<Transitions>::match(reader), true)
+                                    : false)
+                               || ...);
+                    }
+            }
+            else
+            {
+                // Check the character of each transition.
+                // If it matches, we advance by one and go to that node.
+                // As soon as we do that, we return true to short circuit the search.
+                (void)((cur == _char_to_int_type<encoding>(Trie.transition_char(Node, Transitions))
+                            ? (reader.bump(), result = transition<Transitions>::match(reader), true)
+                            : false)
+                       || ...);
+            }
             (void)cur;
 
             if constexpr (Trie.node_accept(Node))
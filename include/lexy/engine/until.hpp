@@ -20,6 +20,12 @@ struct engine_until : engine_matcher_base
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
+        if constexpr (_engine_can_scan<Condition, Reader>)
+        {
+            if (!_detail::is_constant_evaluated())
+                return _match_scan(reader);
+        }
+
         while (!engine_try_match<Condition>(reader))
         {
             if (reader.eof())
@@ -33,6 +39,22 @@ struct engine_until : engine_matcher_base
 
         return error_code();
     }
+
+    // Same as above, but skips over input where the condition can't match.
+    template <typename Reader>
+    static error_code _match_scan(Reader& reader)
+    {
+        for (_engine_scan<Condition>(reader); !engine_try_match<Condition>(reader);
+             _engine_scan<Condition>(reader))
+        {
+            if (reader.eof())
+                return Condition::match(reader);
+
+            reader.bump();
+        }
+
+        return error_code();
+    }
 };
 } // namespace lexy
 
@@ -51,6 +73,12 @@ struct engine_until_eof : engine_matcher_base
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
+        if constexpr (_engine_can_scan<Condition, Reader>)
+        {
+            if (!_detail::is_constant_evaluated())
+                return _match_scan(reader);
+        }
+
         while (!engine_try_match<Condition>(reader))
         {
             if (reader.eof())
@@ -61,6 +89,22 @@ struct engine_until_eof : engine_matcher_base
 
         return error_code();
     }
+
+    // Same as above, but skips over input where the condition can't match.
+    template <typename Reader>
+    static error_code _match_scan(Reader& reader)
+    {
+        for (_engine_scan<Condition>(reader); !engine_try_match<Condition>(reader);
+             _engine_scan<Condition>(reader))
+        {
+            if (reader.eof())
+                break;
+
+            reader.bump();
+        }
+
+        return error_code();
+    }
 };
 
 template <typename Condition, typename Reader>
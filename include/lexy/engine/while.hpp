@@ -22,6 +22,21 @@ struct engine_while : engine_matcher_base
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
+        if constexpr (_engine_can_skip<Matcher, Reader>)
+        {
+            if (!_detail::is_constant_evaluated())
+            {
+                _engine_skip<Matcher>(reader);
+                return error_code();
+            }
+        }
+        else if constexpr (_engine_can_skip_utf8<Matcher, Reader>)
+        {
+            // This stops early, so we continue normally afterwards.
+            if (!_detail::is_constant_evaluated())
+                _engine_skip_utf8<Matcher, void>(reader);
+        }
+
         while (engine_try_match<Matcher>(reader))
         {}
 
@@ -6,6 +6,7 @@
 #define LEXY_INPUT_BASE_HPP_INCLUDED
 
 #include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
 #include <lexy/encoding.hpp>
 
 #if 0
@@ -92,7 +93,8 @@ public:
         if (_cur == _end)
             return encoding::eof();
         else
-            return encoding::to_int_type(*_cur);
+            // The iterator might refer to a different character type, e.g. char for UTF-8.
+            return encoding::to_int_type(static_cast<typename encoding::char_type>(*_cur));
     }
 
     constexpr void bump() noexcept
@@ -111,10 +113,97 @@ public:
         _cur = _end;
     }
 
+    // Bulk access, see `is_contiguous_byte_reader`.
+    constexpr Iterator _ptr() const noexcept
+    {
+        return _cur;
+    }
+    constexpr Sentinel _limit() const noexcept
+    {
+        return _end;
+    }
+    constexpr void _seek(Iterator pos) noexcept
+    {
+        _cur = pos;
+    }
+
 private:
     Iterator                   _cur;
     LEXY_EMPTY_MEMBER Sentinel _end;
 };
+
+template <typename Reader>
+using _detect_contiguous_reader
+    = decltype(LEXY_DECLVAL(Reader&)._seek(LEXY_DECLVAL(const Reader&)._limit()),
+               LEXY_DECLVAL(const Reader&)._ptr());
+
+// Whether the reader reads single byte code units from contiguous memory.
+// Those readers provide `_ptr()`, which returns a pointer to the current code unit, `_limit()`,
+// which returns a pointer to the end of the input, and `_seek(ptr)`, which sets the current
+// position to any pointer in `[_ptr(), _limit()]`.
+// Engines can use that to process the input in bulk, bypassing `peek()` and `bump()`.
+template <typename Reader>
+constexpr bool is_contiguous_byte_reader = [] {
+    using char_type = typename Reader::char_type;
+    using int_type  = typename Reader::encoding::int_type;
+
+    if constexpr (sizeof(char_type) != 1 || !std::is_integral_v<int_type>)
+        return false;
+    else if constexpr (!is_detected<_detect_contiguous_reader, Reader>)
+        return false;
+    else
+        return std::is_same_v<decltype(LEXY_DECLVAL(const Reader&)._ptr()), const char_type*>
+               && std::is_same_v<decltype(LEXY_DECLVAL(const Reader&)._limit()), const char_type*>;
+}();
+
+template <typename Reader>
+using _detect_sentinel_reader
+    = decltype(LEXY_DECLVAL(Reader&)._seek(LEXY_DECLVAL(const Reader&)._ptr()),
+               Reader::_is_sentinel_terminated);
+
+// Whether the reader reads single byte code units from contiguous memory, where the input ends at
+// the first byte equal to `encoding::eof()`.
+// Those readers declare `static constexpr bool _is_sentinel_terminated = true` and provide
+// `_ptr()` and `_seek(ptr)` as above, where `ptr` can be any pointer up to the sentinel.
+// They are always padded, see `is_padded_reader`.
+// Engines can process the input in bulk as long as they stop at the sentinel.
+template <typename Reader>
+constexpr bool is_sentinel_byte_reader = [] {
+    using char_type = typename Reader::char_type;
+    using int_type  = typename Reader::encoding::int_type;
+
+    if constexpr (sizeof(char_type) != 1 || !std::is_same_v<char_type, int_type>)
+        return false;
+    else if constexpr (!is_detected<_detect_sentinel_reader, Reader>)
+        return false;
+    else if constexpr (!std::is_same_v<decltype(LEXY_DECLVAL(const Reader&)._ptr()),
+                                       const char_type*>)
+        return false;
+    else
+        return Reader::_is_sentinel_terminated;
+}();
+
+/// The number of bytes a padded reader guarantees to be readable at `_limit()` or the sentinel.
+constexpr std::size_t input_padding = 64;
+
+template <typename Reader>
+using _detect_padded_reader = decltype(Reader::_is_padded);
+
+// Whether the reader is a sentinel byte reader, or a contiguous byte reader that declares
+// `static constexpr bool _is_padded = true`. Then `input_padding` bytes starting at `_limit()` or
+// the sentinel can be loaded, so vectorized engines don't need to process the tail of the input
+// separately. The values of those bytes are unspecified.
+template <typename Reader>
+constexpr bool is_padded_reader = [] {
+    if constexpr (is_sentinel_byte_reader<Reader>)
+        return true;
+    else if constexpr (!is_contiguous_byte_reader<Reader>)
+        return false;
+    else if constexpr (!is_detected<_detect_padded_reader, Reader>)
+        return false;
+    else
+        return Reader::_is_padded;
+}();
 } // namespace lexy::_detail
 
 namespace lexy
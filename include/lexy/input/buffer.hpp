@@ -5,8 +5,10 @@
 #ifndef LEXY_INPUT_BUFFER_HPP_INCLUDED
 #define LEXY_INPUT_BUFFER_HPP_INCLUDED
 
+#include <cstdint>
 #include <cstring>
 #include <lexy/_detail/memory_resource.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/error.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/lexeme.hpp>
@@ -16,12 +18,17 @@ namespace lexy
 /// Stores the input that will be parsed.
 /// For encodings with spare code points, it can append an EOF sentinel.
 /// This allows branch-less detection of EOF.
+/// Otherwise, it appends a zero terminator, so EOF only needs to be checked on zero code units.
+/// If `Padded` is true, the memory is aligned and followed by `_detail::input_padding` bytes.
+/// This allows vectorized matching without special handling of the end of the input.
+/// The sentinel is always followed by the padding, as vectorized matching has to look for it.
 template <typename Encoding       = default_encoding,
-          typename MemoryResource = _detail::default_memory_resource>
+          typename MemoryResource = _detail::default_memory_resource, bool Padded = false>
 class buffer
 {
     static constexpr auto _has_sentinel
         = std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+    static constexpr auto _has_padding = Padded || _has_sentinel;
 
 public:
     using encoding  = Encoding;
@@ -58,6 +65,48 @@ public:
         buffer _buffer;
     };
 
+    /// The number of bytes the buffer allocates for `size` characters.
+    /// It includes room for the sentinel or terminator, and the padding.
+    static constexpr std::size_t allocation_size(std::size_t size) noexcept
+    {
+        if constexpr (_has_padding)
+            // The padding has room for the sentinel or terminator.
+            return size * sizeof(char_type) + _detail::input_padding;
+        else
+            return (size + 1) * sizeof(char_type);
+    }
+    /// The alignment of the memory the buffer allocates.
+    static constexpr std::size_t allocation_alignment() noexcept
+    {
+        return Padded ? _detail::input_padding : alignof(char_type);
+    }
+
+    /// Takes ownership of memory containing `size` characters without copying them.
+    /// It must have been allocated by `resource->allocate(allocation_size(size),
+    /// allocation_alignment())`, and the buffer will deallocate it the same way.
+    /// The memory after the characters is overwritten with the sentinel or terminator and padding.
+    static buffer adopt(char_type* data, std::size_t size,
+                        MemoryResource* resource
+                        = _detail::get_memory_resource<MemoryResource>()) noexcept
+    {
+        LEXY_PRECONDITION(reinterpret_cast<std::uintptr_t>(data) % allocation_alignment() == 0);
+        terminate(data, size);
+
+        buffer result(resource);
+        result._data = data;
+        result._size = size;
+        return result;
+    }
+
+    // Gives up ownership of the memory, which must then be deallocated as described in `adopt()`.
+    char_type* _release() && noexcept
+    {
+        auto data = _data;
+        _data     = nullptr;
+        _size     = 0;
+        return data;
+    }
+
     constexpr buffer() noexcept : buffer(_detail::get_memory_resource<MemoryResource>()) {}
 
     constexpr explicit buffer(MemoryResource* resource) noexcept
@@ -115,10 +164,7 @@ public:
         if (!_data)
             return;
 
-        if constexpr (_has_sentinel)
-            _resource->deallocate(_data, (_size + 1) * sizeof(char_type), alignof(char_type));
-        else
-            _resource->deallocate(_data, _size * sizeof(char_type), alignof(char_type));
+        _resource->deallocate(_data, allocation_size(_size), allocation_alignment());
     }
 
     buffer& operator=(const buffer& other)
@@ -185,7 +231,7 @@ public:
         if constexpr (_has_sentinel)
             return _sentinel_reader(_data);
         else
-            return _detail::range_reader<encoding, const char_type*>(_data, _data + _size);
+            return _terminator_reader(_data, _data + _size);
     }
 
 private:
@@ -197,6 +243,9 @@ private:
         using iterator         = const char_type*;
         using canonical_reader = _sentinel_reader;
 
+        // See `_detail::is_sentinel_byte_reader`; the buffer is always padded.
+        static constexpr bool _is_sentinel_terminated = true;
+
         bool eof() const noexcept
         {
             return *_cur == encoding::eof();
@@ -218,6 +267,16 @@ private:
             return _cur;
         }
 
+        // Allows bulk matching; see `_detail::is_sentinel_byte_reader`.
+        iterator _ptr() const noexcept
+        {
+            return _cur;
+        }
+        void _seek(iterator pos) noexcept
+        {
+            _cur = pos;
+        }
+
     private:
         explicit _sentinel_reader(iterator begin) noexcept : _cur(begin) {}
 
@@ -225,18 +284,84 @@ private:
         friend buffer;
     };
 
-    char_type* allocate(std::size_t size) const
+    class _terminator_reader
     {
-        if constexpr (_has_sentinel)
-            ++size;
+    public:
+        using encoding         = Encoding;
+        using char_type        = typename encoding::char_type;
+        using iterator         = const char_type*;
+        using canonical_reader = _terminator_reader;
+
+        // See `_detail::is_padded_reader`.
+        static constexpr bool _is_padded = Padded;
+
+        bool eof() const noexcept
+        {
+            // The last one will be the terminator, but it can also occur in the input.
+            return *_cur == char_type() && _cur == _end;
+        }
+
+        auto peek() const noexcept
+        {
+            auto c = *_cur;
+            if (c == char_type() && _cur == _end)
+                return encoding::eof();
+            else
+                return encoding::to_int_type(c);
+        }
+
+        void bump() noexcept
+        {
+            ++_cur;
+        }
+
+        iterator cur() const noexcept
+        {
+            return _cur;
+        }
 
+        // Allows bulk matching; see `_detail::is_contiguous_byte_reader`.
+        iterator _ptr() const noexcept
+        {
+            return _cur;
+        }
+        iterator _limit() const noexcept
+        {
+            return _end;
+        }
+        void _seek(iterator pos) noexcept
+        {
+            _cur = pos;
+        }
+
+    private:
+        explicit _terminator_reader(iterator begin, iterator end) noexcept : _cur(begin), _end(end)
+        {}
+
+        iterator _cur;
+        iterator _end;
+        friend buffer;
+    };
+
+    char_type* allocate(std::size_t size) const
+    {
         auto memory = static_cast<char_type*>(
-            _resource->allocate(size * sizeof(char_type), alignof(char_type)));
-        if constexpr (_has_sentinel)
-            memory[size - 1] = encoding::eof();
+            _resource->allocate(allocation_size(size), allocation_alignment()));
+        terminate(memory, size);
         return memory;
     }
 
+    static void terminate(char_type* memory, std::size_t size) noexcept
+    {
+        if constexpr (_has_padding)
+            // Vectorized matching reads the padding, so it must be initialized.
+            std::memset(memory + size, 0, _detail::input_padding);
+        if constexpr (_has_sentinel)
+            memory[size] = encoding::eof();
+        else
+            memory[size] = char_type();
+    }
+
     LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
     char_type*                                                     _data;
     std::size_t                                                    _size;
@@ -284,29 +409,16 @@ struct _make_buffer
         }
         else
         {
+            constexpr auto is_char16 = std::is_same_v<char_type, char16_t>;
+            constexpr auto is_char32 = std::is_same_v<char_type, char32_t>;
+            static_assert(is_char16 || is_char32, "unhandled encoding/endianness");
+
             typename buffer<Encoding, MemoryResource>::builder builder(size / sizeof(char_type),
                                                                        resource);
 
-            const auto end = memory + size;
-            for (auto dest = builder.data(); memory != end; memory += sizeof(char_type))
-            {
-                constexpr auto is_char16 = std::is_same_v<char_type, char16_t>;
-                constexpr auto is_char32 = std::is_same_v<char_type, char32_t>;
-
-                // We convert each group of bytes to the appropriate value.
-                if constexpr (is_char16 && Endian == encoding_endianness::little)
-                    *dest++ = static_cast<char_type>((memory[0] << 0) | (memory[1] << 8));
-                else if constexpr (is_char32 && Endian == encoding_endianness::little)
-                    *dest++ = static_cast<char_type>((memory[0] << 0) | (memory[1] << 8)
-                                                     | (memory[2] << 16) | (memory[3] << 24));
-                else if constexpr (is_char16 && Endian == encoding_endianness::big)
-                    *dest++ = static_cast<char_type>((memory[0] << 8) | (memory[1] << 0));
-                else if constexpr (is_char32 && Endian == encoding_endianness::big)
-                    *dest++ = static_cast<char_type>((memory[0] << 24) | (memory[1] << 16)
-                                                     | (memory[2] << 8) | (memory[3] << 0));
-                else
-                    static_assert(_detail::error<Encoding>, "unhandled encoding/endianness");
-            }
+            // We need to reverse the bytes of each code unit.
+            auto dest = reinterpret_cast<unsigned char*>(builder.data());
+            _detail::byte_swap_copy<sizeof(char_type)>(dest, memory, builder.size());
 
             return LEXY_MOV(builder).finish();
         }
@@ -367,7 +479,7 @@ struct _make_buffer<utf32_encoding, encoding_endianness::bom>
             return utf32_big(memory, size, resource);
         else if (memory[0] == 0xFF && memory[1] == 0xFE && memory[2] == 0x00 && memory[3] == 0x00)
             return utf32_little(memory + 4, size - 4, resource);
-        else if (memory[0] == 0x00 && memory[1] == 0x00 && memory[2] == 0xFE && memory[3])
+        else if (memory[0] == 0x00 && memory[1] == 0x00 && memory[2] == 0xFE && memory[3] == 0xFF)
             return utf32_big(memory + 4, size - 4, resource);
         else
             return utf32_big(memory, size, resource);
@@ -378,6 +490,154 @@ struct _make_buffer<utf32_encoding, encoding_endianness::bom>
 template <typename Encoding, encoding_endianness Endianness>
 constexpr auto make_buffer_from_raw = _make_buffer<Encoding, Endianness>{};
 
+//=== make_buffer_as ===//
+// Transcodes UTF-16 or UTF-32 (Size is 2 or 4) to UTF-8.
+template <std::size_t Size, bool BigEndian>
+struct _utf8_transcoder
+{
+    static char32_t load(const unsigned char* ptr) noexcept
+    {
+        auto result = char32_t(0);
+        for (auto i = 0u; i != Size; ++i)
+        {
+            auto byte = BigEndian ? ptr[i] : ptr[Size - 1 - i];
+            result    = char32_t(result << 8) | byte;
+        }
+        return result;
+    }
+
+    // Decodes the next code point, replacing invalid ones with U+FFFD.
+    static char32_t decode(const unsigned char*& cur, const unsigned char* end) noexcept
+    {
+        if (std::size_t(end - cur) < Size)
+        {
+            // Incomplete code unit at the end.
+            cur = end;
+            return 0xFFFD;
+        }
+
+        auto unit = load(cur);
+        cur += Size;
+        if (unit < 0xD800 || (unit > 0xDFFF && unit <= 0x10FFFF))
+            return unit;
+        else if (Size == 2 && unit <= 0xDBFF && end - cur >= 2)
+        {
+            auto trail = load(cur);
+            if (trail < 0xDC00 || trail > 0xDFFF)
+                return 0xFFFD;
+
+            cur += 2;
+            return 0x10000 + ((unit - 0xD800) << 10) + (trail - 0xDC00);
+        }
+        else
+            return 0xFFFD;
+    }
+
+    static unsigned char* encode(unsigned char* dest, char32_t cp) noexcept
+    {
+        if (cp < 0x80)
+        {
+            *dest++ = static_cast<unsigned char>(cp);
+        }
+        else if (cp < 0x800)
+        {
+            *dest++ = static_cast<unsigned char>(0xC0 | (cp >> 6));
+            *dest++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            *dest++ = static_cast<unsigned char>(0xE0 | (cp >> 12));
+            *dest++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+            *dest++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            *dest++ = static_cast<unsigned char>(0xF0 | (cp >> 18));
+            *dest++ = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+            *dest++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+            *dest++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        }
+        return dest;
+    }
+
+    // Transcodes the input to dest, or only computes the size if dest is null.
+    // Returns the number of bytes.
+    static std::size_t transcode(unsigned char* dest, const unsigned char* cur,
+                                 const unsigned char* end) noexcept
+    {
+        auto size = std::size_t(0);
+        while (cur != end)
+        {
+            auto ascii = _detail::narrow_ascii<Size, BigEndian>(dest, cur,
+                                                               std::size_t(end - cur) / Size);
+            cur += ascii * Size;
+            size += ascii;
+            if (dest)
+                dest += ascii;
+            if (cur == end)
+                break;
+
+            auto cp = decode(cur, end);
+            if (dest)
+            {
+                auto next = encode(dest, cp);
+                size += std::size_t(next - dest);
+                dest = next;
+            }
+            else
+            {
+                unsigned char tmp[4];
+                size += std::size_t(encode(tmp, cp) - tmp);
+            }
+        }
+        return size;
+    }
+
+    template <typename MemoryResource>
+    static auto make(const unsigned char* memory, std::size_t size, MemoryResource* resource)
+    {
+        auto length = transcode(nullptr, memory, memory + size);
+
+        typename buffer<utf8_encoding, MemoryResource>::builder builder(length, resource);
+        transcode(reinterpret_cast<unsigned char*>(builder.data()), memory, memory + size);
+        return LEXY_MOV(builder).finish();
+    }
+};
+
+template <typename Encoding>
+struct _make_buffer_as
+{
+    static_assert(std::is_same_v<Encoding, utf8_encoding>, "only UTF-8 is supported");
+
+    template <typename MemoryResource = _detail::default_memory_resource>
+    auto operator()(const void* _memory, std::size_t size,
+                    MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
+    {
+        auto memory = static_cast<const unsigned char*>(_memory);
+
+        // We need to check the UTF-32 BOMs first, as the little endian one starts with the
+        // UTF-16 one.
+        if (size >= 4 && memory[0] == 0xFF && memory[1] == 0xFE && memory[2] == 0x00
+            && memory[3] == 0x00)
+            return _utf8_transcoder<4, false>::make(memory + 4, size - 4, resource);
+        else if (size >= 4 && memory[0] == 0x00 && memory[1] == 0x00 && memory[2] == 0xFE
+                 && memory[3] == 0xFF)
+            return _utf8_transcoder<4, true>::make(memory + 4, size - 4, resource);
+        else if (size >= 2 && memory[0] == 0xFF && memory[1] == 0xFE)
+            return _utf8_transcoder<2, false>::make(memory + 2, size - 2, resource);
+        else if (size >= 2 && memory[0] == 0xFE && memory[1] == 0xFF)
+            return _utf8_transcoder<2, true>::make(memory + 2, size - 2, resource);
+        else
+            // UTF-8 with or without BOM.
+            return _make_buffer<utf8_encoding, encoding_endianness::bom>{}(memory, size, resource);
+    }
+};
+
+/// Creates a buffer with the specified encoding from raw memory in any Unicode encoding.
+/// The source encoding is detected using the BOM, without one it is assumed to be the target.
+template <typename Encoding>
+constexpr auto make_buffer_as = _make_buffer_as<Encoding>{};
+
 //=== convenience typedefs ===//
 template <typename Encoding       = default_encoding,
           typename MemoryResource = _detail::default_memory_resource>
@@ -390,6 +650,24 @@ using buffer_error = error_for<buffer<Encoding, MemoryResource>, Tag>;
 template <typename Production, typename Encoding = default_encoding,
           typename MemoryResource = _detail::default_memory_resource>
 using buffer_error_context = error_context<Production, buffer<Encoding, MemoryResource>>;
+
+/// A buffer whose memory is padded for vectorized matching.
+template <typename Encoding       = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource>
+using padded_buffer = buffer<Encoding, MemoryResource, true>;
+
+template <typename Encoding       = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource>
+using padded_buffer_lexeme = lexeme_for<padded_buffer<Encoding, MemoryResource>>;
+
+template <typename Tag, typename Encoding = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource>
+using padded_buffer_error = error_for<padded_buffer<Encoding, MemoryResource>, Tag>;
+
+template <typename Production, typename Encoding = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource>
+using padded_buffer_error_context
+    = error_context<Production, padded_buffer<Encoding, MemoryResource>>;
 } // namespace lexy
 
 #endif // LEXY_INPUT_BUFFER_HPP_INCLUDED
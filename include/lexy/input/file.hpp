@@ -5,6 +5,8 @@
 #ifndef LEXY_INPUT_FILE_HPP_INCLUDED
 #define LEXY_INPUT_FILE_HPP_INCLUDED
 
+#include <mutex>
+
 #include <lexy/_detail/std.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/input/buffer.hpp>
@@ -25,6 +27,23 @@ enum class file_error
 };
 } // namespace lexy
 
+namespace lexy
+{
+/// Hints about how a memory-mapped file is accessed.
+enum class file_advice
+{
+    /// No special treatment.
+    normal,
+    /// The file is accessed from beginning to end, so pages can be read ahead aggressively and
+    /// freed soon after they have been accessed.
+    sequential,
+    /// The file is accessed in random order, so read ahead is useless.
+    random,
+    /// The entire file will be accessed soon, so it should be read ahead now.
+    will_need,
+};
+} // namespace lexy
+
 namespace lexy::_detail
 {
 using file_callback = void (*)(void* user_data, const char* memory, std::size_t size);
@@ -35,6 +54,29 @@ using file_callback = void (*)(void* user_data, const char* memory, std::size_t
 //
 // Do not change ABI, especially with different build configurations!
 file_error read_file(const char* path, file_callback cb, void* user_data);
+
+using file_batch_callback = void (*)(void* user_data, std::size_t index, file_error error,
+                                     const char* memory, std::size_t size);
+
+// Reads the files concurrently using `thread_count` threads, including the calling one, or one per
+// hardware thread if it is zero.
+// For each file, invokes the callback concurrently with its index and either `file_error::_success`
+// and the contents, or the error. If it throws on success, it is invoked again with
+// `file_error::os_error`, where it must not throw.
+// Exceptions are rethrown once all files have been processed.
+//
+// Do not change ABI, especially with different build configurations!
+void read_files(const char* const* paths, std::size_t count, std::size_t thread_count,
+                file_batch_callback cb, void* user_data);
+
+// Maps the entire file into memory, or reads it into newly allocated memory if the OS doesn't
+// support it. The memory stays valid until it is passed to `unmap_file()`.
+// An empty file results in null memory.
+//
+// Do not change ABI, especially with different build configurations!
+file_error map_file(const char* path, const char*& memory, std::size_t& size);
+void       unmap_file(const char* memory, std::size_t size) noexcept;
+void       advise_file(const char* memory, std::size_t size, file_advice advice) noexcept;
 } // namespace lexy::_detail
 
 namespace lexy
@@ -70,6 +112,287 @@ auto read_file(const char*     path,
     else
         return {lexy::result_error, error};
 }
+
+/// Reads the file at the specified path into a buffer, converting it from the Unicode encoding
+/// indicated by its BOM to the specified encoding.
+template <typename Encoding, typename MemoryResource = _detail::default_memory_resource>
+auto read_file_as(const char*     path,
+                  MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
+    -> result<buffer<Encoding, MemoryResource>, file_error>
+{
+    using buffer_type = buffer<Encoding, MemoryResource>;
+
+    struct user_data_t
+    {
+        buffer_type     buffer;
+        MemoryResource* resource;
+    } user_data{buffer_type(resource), resource};
+
+    auto error = _detail::read_file(
+        path,
+        [](void* _user_data, const char* memory, std::size_t size) {
+            auto user_data = static_cast<user_data_t*>(_user_data);
+
+            user_data->buffer = lexy::make_buffer_as<Encoding>(memory, size, user_data->resource);
+        },
+        &user_data);
+
+    if (error == file_error::_success)
+        return {lexy::result_value, LEXY_MOV(user_data.buffer)};
+    else
+        return {lexy::result_error, error};
+}
+} // namespace lexy
+
+namespace lexy
+{
+/// The results of reading multiple files with `read_files()`.
+template <typename Encoding       = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource>
+class file_batch
+{
+public:
+    using buffer_type = buffer<Encoding, MemoryResource>;
+    using result_type = result<buffer_type, file_error>;
+
+    //=== constructors ===//
+    file_batch(const file_batch&) = delete;
+    file_batch& operator=(const file_batch&) = delete;
+
+    file_batch(file_batch&& other) noexcept
+    : _resource(other._resource), _results(other._results), _size(other._size)
+    {
+        other._results = nullptr;
+        other._size    = 0;
+    }
+
+    ~file_batch() noexcept
+    {
+        if (!_results)
+            return;
+
+        for (auto i = std::size_t(0); i != _size; ++i)
+            _results[i].~result_type();
+        _resource->deallocate(_results, _size * sizeof(result_type), alignof(result_type));
+    }
+
+    //=== access ===//
+    /// The result of reading the file at the same index in the list of paths.
+    result_type& operator[](std::size_t idx) noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _results[idx];
+    }
+    const result_type& operator[](std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _results[idx];
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+private:
+    explicit file_batch(std::size_t size, MemoryResource* resource)
+    : _resource(resource), _results(nullptr), _size(size)
+    {
+        if (size > 0)
+            _results = static_cast<result_type*>(
+                _resource->allocate(size * sizeof(result_type), alignof(result_type)));
+    }
+
+    LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
+    result_type*                                                   _results;
+    std::size_t                                                    _size;
+
+    template <typename E, encoding_endianness Endian, typename MR>
+    friend auto read_files(const char* const* paths, std::size_t count, std::size_t thread_count,
+                           MR* resource) -> file_batch<E, MR>;
+};
+} // namespace lexy
+
+namespace lexy::_detail
+{
+// Serializes the calls to a memory resource, so it can be shared by multiple threads.
+template <typename MemoryResource>
+class locking_memory_resource
+{
+public:
+    explicit locking_memory_resource(MemoryResource* resource) noexcept : _resource(resource) {}
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _resource->allocate(bytes, alignment);
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _resource->deallocate(ptr, bytes, alignment);
+    }
+
+    friend bool operator==(const locking_memory_resource& lhs,
+                           const locking_memory_resource& rhs) noexcept
+    {
+        return &lhs == &rhs;
+    }
+
+private:
+    MemoryResource* _resource;
+    std::mutex      _mutex;
+};
+} // namespace lexy::_detail
+
+namespace lexy
+{
+/// Reads the files at the specified paths into buffers, using `thread_count` threads or one per
+/// hardware thread if it is zero.
+/// Calls to a memory resource other than the default one are serialized, so it can be an arena.
+template <typename Encoding          = default_encoding,
+          encoding_endianness Endian = encoding_endianness::bom,
+          typename MemoryResource    = _detail::default_memory_resource>
+auto read_files(const char* const* paths, std::size_t count, std::size_t thread_count = 0,
+                MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
+    -> file_batch<Encoding, MemoryResource>
+{
+    using batch_type = file_batch<Encoding, MemoryResource>;
+    // The default resource is thread-safe.
+    constexpr auto needs_lock = !std::is_same_v<MemoryResource, _detail::default_memory_resource>;
+    using locking_resource    = _detail::locking_memory_resource<MemoryResource>;
+
+    struct user_data_t
+    {
+        batch_type       batch;
+        MemoryResource*  resource;
+        locking_resource locking;
+    } user_data{batch_type(count, resource), resource, locking_resource(resource)};
+
+    _detail::read_files(
+        paths, count, thread_count,
+        [](void* _user_data, std::size_t index, file_error error, const char* memory,
+           std::size_t size) {
+            using buffer_type = typename batch_type::buffer_type;
+            auto user_data    = static_cast<user_data_t*>(_user_data);
+            auto result       = user_data->batch._results + index;
+
+            if (error != file_error::_success)
+                ::new (static_cast<void*>(result))
+                    typename batch_type::result_type(lexy::result_error, error);
+            else if constexpr (needs_lock)
+            {
+                // Only the allocation is serialized, the buffer then takes ownership of it.
+                auto tmp
+                    = lexy::make_buffer_from_raw<Encoding, Endian>(memory, size, &user_data->locking);
+                auto tmp_size = tmp.size();
+                ::new (static_cast<void*>(result)) typename batch_type::result_type(
+                    lexy::result_value,
+                    buffer_type::adopt(LEXY_MOV(tmp)._release(), tmp_size, user_data->resource));
+            }
+            else
+                ::new (static_cast<void*>(result)) typename batch_type::result_type(
+                    lexy::result_value,
+                    lexy::make_buffer_from_raw<Encoding, Endian>(memory, size, user_data->resource));
+        },
+        &user_data);
+
+    return LEXY_MOV(user_data.batch);
+}
+} // namespace lexy
+
+namespace lexy
+{
+/// A file that is mapped into memory and used as input without copying it.
+template <typename Encoding = default_encoding>
+class mapped_file
+{
+    static_assert(sizeof(typename Encoding::char_type) == 1,
+                  "a mapped file requires a single byte encoding");
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+
+    //=== constructors ===//
+    /// Creates an empty mapping.
+    constexpr mapped_file() noexcept : _memory(nullptr), _size(0) {}
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept : _memory(other._memory), _size(other._size)
+    {
+        other._memory = nullptr;
+        other._size   = 0;
+    }
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        _detail::swap(_memory, other._memory);
+        _detail::swap(_size, other._size);
+        return *this;
+    }
+
+    ~mapped_file() noexcept
+    {
+        if (_memory != nullptr)
+            _detail::unmap_file(_memory, _size);
+    }
+
+    //=== access ===//
+    const char_type* data() const noexcept
+    {
+        return reinterpret_cast<const char_type*>(_memory);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// Tells the OS how the file is going to be accessed.
+    void advise(file_advice advice) const noexcept
+    {
+        if (_memory != nullptr)
+            _detail::advise_file(_memory, _size, advice);
+    }
+
+    //=== input ===//
+    auto reader() const& noexcept
+    {
+        return _detail::range_reader<encoding, const char_type*>(data(), data() + _size);
+    }
+
+private:
+    explicit mapped_file(const char* memory, std::size_t size) noexcept
+    : _memory(memory), _size(size)
+    {}
+
+    const char* _memory;
+    std::size_t _size;
+
+    template <typename E>
+    friend auto map_file(const char* path, file_advice advice)
+        -> result<mapped_file<E>, file_error>;
+};
+
+/// Maps the file at the specified path into memory.
+/// Unlike `read_file()`, the contents are neither copied nor converted.
+template <typename Encoding = default_encoding>
+auto map_file(const char* path, file_advice advice = file_advice::sequential)
+    -> result<mapped_file<Encoding>, file_error>
+{
+    const char* memory = nullptr;
+    std::size_t size   = 0;
+    if (auto error = _detail::map_file(path, memory, size); error != file_error::_success)
+        return {lexy::result_error, error};
+
+    mapped_file<Encoding> file(memory, size);
+    file.advise(advice);
+    return {lexy::result_value, LEXY_MOV(file)};
+}
 } // namespace lexy
 
 #endif // LEXY_INPUT_FILE_HPP_INCLUDED
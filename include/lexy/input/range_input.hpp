@@ -5,10 +5,163 @@
 #ifndef LEXY_INPUT_RANGE_INPUT_HPP_INCLUDED
 #define LEXY_INPUT_RANGE_INPUT_HPP_INCLUDED
 
+#include <lexy/_detail/std.hpp>
 #include <lexy/error.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/lexeme.hpp>
 
+#if defined(__has_include)
+#    if __has_include(<version>)
+#        include <version>
+#    endif
+#endif
+
+#ifndef LEXY_HAS_CONTIGUOUS_ITERATOR
+#    if defined(__cpp_lib_concepts) && defined(__cpp_lib_to_address)
+#        define LEXY_HAS_CONTIGUOUS_ITERATOR 1
+#    else
+#        define LEXY_HAS_CONTIGUOUS_ITERATOR 0
+#    endif
+#endif
+
+#if LEXY_HAS_CONTIGUOUS_ITERATOR
+#    include <iterator>
+#endif
+
+namespace lexy::_detail
+{
+// Whether the iterator points into contiguous memory, and how to get that pointer.
+template <typename Iterator>
+struct contiguous_iterator_traits
+{
+#if LEXY_HAS_CONTIGUOUS_ITERATOR
+    static constexpr bool value = std::contiguous_iterator<Iterator>;
+
+    static constexpr auto to_address(const Iterator& iter) noexcept
+    {
+        return std::to_address(iter);
+    }
+#else
+    static constexpr bool value = false;
+#endif
+};
+
+template <typename T>
+struct contiguous_iterator_traits<T*>
+{
+    static constexpr bool value = true;
+
+    static constexpr T* to_address(T* iter) noexcept
+    {
+        return iter;
+    }
+};
+
+// Before C++20, we recognize the iterators of std::vector and std::basic_string; the ones of
+// std::array and std::basic_string_view are already pointers.
+#if defined(__GLIBCXX__)
+template <typename T, typename Container>
+struct contiguous_iterator_traits<__gnu_cxx::__normal_iterator<T*, Container>>
+{
+    static constexpr bool value = true;
+
+    static constexpr T* to_address(
+        const __gnu_cxx::__normal_iterator<T*, Container>& iter) noexcept
+    {
+        return iter.base();
+    }
+};
+#elif defined(_LIBCPP_VERSION)
+template <typename T>
+struct contiguous_iterator_traits<std::__wrap_iter<T*>>
+{
+    static constexpr bool value = true;
+
+    static constexpr T* to_address(const std::__wrap_iter<T*>& iter) noexcept
+    {
+        return iter.base();
+    }
+};
+#endif
+
+// Whether the range can be read using a pointer to the character type of the encoding.
+template <typename Encoding, typename Iterator, typename Sentinel>
+constexpr bool is_contiguous_range = [] {
+    using traits = contiguous_iterator_traits<Iterator>;
+    if constexpr (!std::is_same_v<Iterator, Sentinel> || !traits::value)
+        return false;
+    else
+    {
+        using pointer = decltype(traits::to_address(LEXY_DECLVAL(const Iterator&)));
+        return std::is_same_v<std::remove_cv_t<std::remove_pointer_t<pointer>>,
+                              typename Encoding::char_type>;
+    }
+}();
+
+// Reads a contiguous range through pointers, but its positions are still iterators of the range.
+template <typename Encoding, typename Iterator>
+class contiguous_range_reader
+{
+public:
+    using encoding         = Encoding;
+    using char_type        = typename encoding::char_type;
+    using iterator         = Iterator;
+    using canonical_reader = contiguous_range_reader<Encoding, Iterator>;
+
+    constexpr explicit contiguous_range_reader(Iterator begin, Iterator end) noexcept
+    : _cur(_to_address(begin)), _end(_to_address(end)), _begin_ptr(_cur), _begin(begin)
+    {}
+
+    constexpr bool eof() const noexcept
+    {
+        return _cur == _end;
+    }
+
+    constexpr auto peek() const noexcept
+    {
+        if (_cur == _end)
+            return encoding::eof();
+        else
+            return encoding::to_int_type(*_cur);
+    }
+
+    constexpr void bump() noexcept
+    {
+        ++_cur;
+    }
+
+    constexpr iterator cur() const noexcept
+    {
+        return _begin + (_cur - _begin_ptr);
+    }
+
+    // Bulk access, see `is_contiguous_byte_reader`.
+    constexpr const char_type* _ptr() const noexcept
+    {
+        return _cur;
+    }
+    constexpr const char_type* _limit() const noexcept
+    {
+        return _end;
+    }
+    constexpr void _seek(const char_type* pos) noexcept
+    {
+        _cur = pos;
+    }
+
+private:
+    static constexpr const char_type* _to_address(const Iterator& iter) noexcept
+    {
+        return contiguous_iterator_traits<Iterator>::to_address(iter);
+    }
+
+    const char_type* _cur;
+    const char_type* _end;
+    const char_type* _begin_ptr;
+    Iterator         _begin;
+};
+} // namespace lexy::_detail
+
 namespace lexy
 {
 template <typename Encoding, typename Iterator, typename Sentinel = Iterator>
@@ -39,7 +192,12 @@ public:
     //=== reader ===//
     constexpr auto reader() const& noexcept
     {
-        return _detail::range_reader<Encoding, Iterator, Sentinel>(_begin, _end);
+        // If possible, we read through pointers, which allows bulk matching.
+        if constexpr (!std::is_pointer_v<Iterator>
+                      && _detail::is_contiguous_range<Encoding, Iterator, Sentinel>)
+            return _detail::contiguous_range_reader<Encoding, Iterator>(_begin, _end);
+        else
+            return _detail::range_reader<Encoding, Iterator, Sentinel>(_begin, _end);
     }
 
 private:
@@ -0,0 +1,346 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+#define LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/error.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/lexeme.hpp>
+
+namespace lexy
+{
+#if 0
+/// Provides the characters of a stream.
+class Source
+{
+    using encoding = ...;
+
+    /// Reads at most `size` characters into the `buffer`.
+    /// Returns the number of characters read; zero signals the end of the stream.
+    /// It may read fewer than `size` characters without being at the end.
+    /// If reading fails, it returns zero as well, so the source should expose the error separately.
+    std::size_t read(char_type* buffer, std::size_t size);
+};
+#endif
+
+/// Reads from a `std::FILE*`, e.g. `stdin` or a file opened with `fdopen()`.
+template <typename Encoding = default_encoding>
+class file_source
+{
+public:
+    using encoding  = Encoding;
+    using char_type = typename Encoding::char_type;
+
+    explicit file_source(std::FILE* file) noexcept : _file(file) {}
+
+    std::size_t read(char_type* buffer, std::size_t size) noexcept
+    {
+        return std::fread(buffer, sizeof(char_type), size, _file);
+    }
+
+    /// Whether reading has failed instead of reaching the end of the file, i.e. `std::ferror()`.
+    /// Then the input appears to end early, so it must be checked after parsing.
+    bool error() const noexcept
+    {
+        return std::ferror(_file) != 0;
+    }
+
+private:
+    std::FILE* _file;
+};
+} // namespace lexy
+
+namespace lexy
+{
+/// Reads input from a stream on demand, keeping only a window of it in memory.
+///
+/// The characters are stored in a ring of chunks of `chunk_size` characters each, initially
+/// `chunk_count` many. Once all chunks are full, reading more input discards the oldest one, unless
+/// a reader still refers to it; then the ring grows instead, without limit.
+/// Every other position is guaranteed to be available as long as the parser hasn't looked further
+/// than `max_lookahead()` characters past it.
+template <typename Source = file_source<>>
+class stream_input
+{
+public:
+    using encoding    = typename Source::encoding;
+    using char_type   = typename encoding::char_type;
+    using source_type = Source;
+
+    static constexpr std::size_t default_chunk_size  = 64 * 1024;
+    static constexpr std::size_t default_chunk_count = 4;
+
+    /// Throws `std::bad_array_new_length` if `chunk_size * chunk_count` overflows.
+    explicit stream_input(Source source, std::size_t chunk_size = default_chunk_size,
+                          std::size_t chunk_count = default_chunk_count)
+    : _source(LEXY_MOV(source)), _chunk_size(chunk_size), _chunk_count(chunk_count),
+      _memory(_allocate(chunk_size, chunk_count)), _pins(new std::size_t[chunk_count + 1]{}),
+      _first_chunk(0), _end(0), _eof(false)
+    {
+        LEXY_PRECONDITION(chunk_size > 0 && chunk_count > 1);
+    }
+
+    stream_input(const stream_input&) = delete;
+    stream_input& operator=(const stream_input&) = delete;
+
+    ~stream_input() noexcept
+    {
+        delete[] _memory;
+        delete[] _pins;
+    }
+
+    /// The source, e.g. to check whether the stream ended because of an error.
+    const Source& source() const noexcept
+    {
+        return _source;
+    }
+
+    /// The number of characters the parser can look ahead while still keeping a position valid.
+    std::size_t max_lookahead() const noexcept
+    {
+        return (_chunk_count - 1) * _chunk_size;
+    }
+
+    /// Whether or not the character at the position is still in memory.
+    bool is_available(std::size_t pos) const noexcept
+    {
+        return _first_chunk * _chunk_size <= pos && pos < _end;
+    }
+
+    class iterator : public _detail::forward_iterator_base<iterator, const char_type>
+    {
+    public:
+        iterator() noexcept = default;
+
+        /// The offset of the character from the beginning of the stream.
+        std::size_t position() const noexcept
+        {
+            return _pos;
+        }
+
+        const char_type& deref() const noexcept
+        {
+            return _input->_at(_pos);
+        }
+
+        void increment() noexcept
+        {
+            ++_pos;
+        }
+
+        bool equal(iterator rhs) const noexcept
+        {
+            return _input == rhs._input && _pos == rhs._pos;
+        }
+
+    private:
+        explicit iterator(const stream_input* input, std::size_t pos) noexcept
+        : _input(input), _pos(pos)
+        {}
+
+        const stream_input* _input = nullptr;
+        std::size_t         _pos   = 0;
+
+        friend stream_input;
+    };
+
+    // A reader pins the chunk of its position: it is not discarded while the reader exists.
+    // As the parser backtracks by copying readers, it never loses input it can backtrack to.
+    class _reader
+    {
+    public:
+        using encoding         = typename stream_input::encoding;
+        using char_type        = typename stream_input::char_type;
+        using iterator         = typename stream_input::iterator;
+        using canonical_reader = _reader;
+
+        _reader(const _reader& other) noexcept
+        : _input(other._input), _pos(other._pos), _chunk_end(other._chunk_end)
+        {
+            _input->_pin(_pos);
+        }
+
+        _reader& operator=(const _reader& other) noexcept
+        {
+            other._input->_pin(other._pos);
+            _input->_unpin(_pos);
+
+            _input     = other._input;
+            _pos       = other._pos;
+            _chunk_end = other._chunk_end;
+            return *this;
+        }
+
+        ~_reader() noexcept
+        {
+            _input->_unpin(_pos);
+        }
+
+        bool eof() const
+        {
+            // We only need to read more input, if we've consumed everything that is buffered.
+            return _pos == _input->_end && !_input->_read_more();
+        }
+
+        auto peek() const
+        {
+            if (eof())
+                return encoding::eof();
+            else
+                return encoding::to_int_type(_input->_at(_pos));
+        }
+
+        void bump() noexcept
+        {
+            if (++_pos == _chunk_end)
+            {
+                // We've moved to the next chunk.
+                _input->_pin(_pos);
+                _input->_unpin(_pos - 1);
+                _chunk_end += _input->_chunk_size;
+            }
+        }
+
+        iterator cur() const noexcept
+        {
+            return iterator(_input, _pos);
+        }
+
+    private:
+        explicit _reader(const stream_input* input) noexcept
+        : _input(input), _pos(0), _chunk_end(input->_chunk_size)
+        {
+            _input->_pin(_pos);
+        }
+
+        const stream_input* _input;
+        std::size_t         _pos;
+        std::size_t         _chunk_end; // The position where the next chunk begins.
+
+        friend stream_input;
+    };
+
+    /// The stream can only be parsed once, as it starts discarding characters.
+    auto reader() const& noexcept
+    {
+        LEXY_PRECONDITION(_first_chunk == 0);
+        return _reader(this);
+    }
+
+private:
+    static char_type* _allocate(std::size_t chunk_size, std::size_t chunk_count)
+    {
+        if (chunk_size != 0 && chunk_count > std::size_t(-1) / sizeof(char_type) / chunk_size)
+            throw std::bad_array_new_length();
+        return new char_type[chunk_size * chunk_count];
+    }
+
+    const char_type& _at(std::size_t pos) const noexcept
+    {
+        LEXY_PRECONDITION(is_available(pos));
+        auto chunk = (pos / _chunk_size) % _chunk_count;
+        return _memory[chunk * _chunk_size + pos % _chunk_size];
+    }
+
+    // The number of readers in each chunk, starting at the oldest one.
+    // The extra one is for readers at the end of a full ring, before we've read more.
+    std::size_t& _pins_of(std::size_t pos) const noexcept
+    {
+        LEXY_PRECONDITION(_first_chunk * _chunk_size <= pos && pos <= _end);
+        return _pins[pos / _chunk_size - _first_chunk];
+    }
+    void _pin(std::size_t pos) const noexcept
+    {
+        ++_pins_of(pos);
+    }
+    void _unpin(std::size_t pos) const noexcept
+    {
+        --_pins_of(pos);
+    }
+
+    // Doubles the number of chunks, keeping the characters at their position.
+    void _grow() const
+    {
+        auto chunk_count = 2 * _chunk_count;
+        auto memory      = _allocate(_chunk_size, chunk_count);
+        auto pins        = new std::size_t[chunk_count + 1]{};
+
+        for (auto chunk = _first_chunk; chunk != _first_chunk + _chunk_count; ++chunk)
+            std::memcpy(memory + (chunk % chunk_count) * _chunk_size,
+                        _memory + (chunk % _chunk_count) * _chunk_size,
+                        _chunk_size * sizeof(char_type));
+        std::memcpy(pins, _pins, (_chunk_count + 1) * sizeof(std::size_t));
+
+        delete[] _memory;
+        delete[] _pins;
+        _memory      = memory;
+        _pins        = pins;
+        _chunk_count = chunk_count;
+    }
+
+    // Returns whether or not we've read anything.
+    bool _read_more() const
+    {
+        if (_eof)
+            return false;
+
+        auto chunk  = _end / _chunk_size;
+        auto offset = _end % _chunk_size;
+        if (chunk - _first_chunk == _chunk_count)
+        {
+            // All chunks are full, so we need to re-use the oldest one, unless it is pinned.
+            if (_pins[0] == 0)
+            {
+                ++_first_chunk;
+                std::memmove(_pins, _pins + 1, _chunk_count * sizeof(std::size_t));
+                _pins[_chunk_count] = 0;
+            }
+            else
+                _grow();
+        }
+
+        // Read into the remaining part of the current chunk.
+        auto buffer = _memory + (chunk % _chunk_count) * _chunk_size + offset;
+        auto read   = _source.read(buffer, _chunk_size - offset);
+        if (read == 0)
+        {
+            _eof = true;
+            return false;
+        }
+
+        _end += read;
+        return true;
+    }
+
+    // The stream is only modified by readers, which get a const reference to the input.
+    mutable Source       _source;
+    std::size_t          _chunk_size;
+    mutable std::size_t  _chunk_count;
+    mutable char_type*   _memory;
+    mutable std::size_t* _pins;
+    mutable std::size_t  _first_chunk; // The absolute index of the oldest chunk in memory.
+    mutable std::size_t  _end;         // The absolute position after the last character read.
+    mutable bool         _eof;
+};
+
+//=== convenience typedefs ===//
+template <typename Source = file_source<>>
+using stream_lexeme = lexeme_for<stream_input<Source>>;
+
+template <typename Tag, typename Source = file_source<>>
+using stream_error = error_for<stream_input<Source>, Tag>;
+
+template <typename Production, typename Source = file_source<>>
+using stream_error_context = error_context<Production, stream_input<Source>>;
+} // namespace lexy
+
+#endif // LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+
@@ -32,6 +32,9 @@ public:
         return {};
     }
 
+    // All tokens are discarded.
+    static constexpr bool ignores_tokens = true;
+
     template <typename Kind, typename Iterator>
     constexpr void token(Kind, Iterator, Iterator)
     {}
@@ -212,6 +212,18 @@ struct pt_node_production : pt_node<Reader>
 } // namespace lexy::_detail
 
 //=== internal: pt_buffer ===//
+namespace lexy
+{
+/// The sizes of the memory blocks that store the nodes of a parse tree.
+struct parse_tree_block_sizes
+{
+    /// The size of the first block.
+    std::size_t initial = 4096;
+    /// Every further block is twice as big as the previous one, up to this size.
+    std::size_t max = 4096;
+};
+} // namespace lexy
+
 namespace lexy::_detail
 {
 // Basic stack allocator to store all the nodes of a tree.
@@ -220,43 +232,58 @@ class pt_buffer
 {
     using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
 
-    static constexpr std::size_t block_size = 4096 - sizeof(void*);
-
+    // The memory of the block is stored immediately after it.
     struct block
     {
-        block*        next;
-        unsigned char memory[block_size];
+        block*      prev;
+        block*      next;
+        std::size_t size; // Including the block itself.
 
-        static block* allocate(resource_ptr resource)
+        static block* allocate(resource_ptr resource, block* prev, std::size_t size)
         {
-            auto memory = resource->allocate(sizeof(block), alignof(block));
-            auto ptr    = ::new (memory) block; // Don't initialize array!
-            ptr->next   = nullptr;
-            return ptr;
+            auto memory = resource->allocate(size, alignof(block));
+            return ::new (memory) block{prev, nullptr, size}; // Don't initialize memory!
         }
 
         static block* deallocate(resource_ptr resource, block* ptr)
         {
             auto next = ptr->next;
-            resource->deallocate(ptr, sizeof(block), alignof(block));
+            resource->deallocate(ptr, ptr->size, alignof(block));
             return next;
         }
 
+        unsigned char* memory() noexcept
+        {
+            return reinterpret_cast<unsigned char*>(this + 1);
+        }
         unsigned char* end() noexcept
         {
-            return &memory[block_size];
+            return reinterpret_cast<unsigned char*>(this) + size;
+        }
+
+        bool contains(unsigned char* pos) noexcept
+        {
+            // Note: this is not guaranteed to work by the standard;
+            // We'd have to go through std::less instead.
+            // However, on all implementations I care about, std::less just does < anyway.
+            return memory() <= pos && pos < end();
         }
     };
 
 public:
+    // Every block needs to have room for the biggest node plus a trailing pointer.
+    static constexpr std::size_t min_block_size = sizeof(block) + 8 * sizeof(void*);
+
     //=== constructors/destructors/assignment ===//
-    explicit constexpr pt_buffer(MemoryResource* resource) noexcept
-    : _resource(resource), _head(nullptr), _cur_block(nullptr), _cur_pos(nullptr)
-    {}
+    explicit constexpr pt_buffer(MemoryResource* resource, parse_tree_block_sizes sizes) noexcept
+    : _resource(resource), _sizes(sizes), _head(nullptr), _cur_block(nullptr), _cur_pos(nullptr)
+    {
+        LEXY_PRECONDITION(min_block_size <= sizes.initial && sizes.initial <= sizes.max);
+    }
 
     pt_buffer(pt_buffer&& other) noexcept
-    : _resource(other._resource), _head(other._head), _cur_block(other._cur_block),
-      _cur_pos(other._cur_pos)
+    : _resource(other._resource), _sizes(other._sizes), _head(other._head),
+      _cur_block(other._cur_block), _cur_pos(other._cur_pos)
     {
         other._head = other._cur_block = nullptr;
         other._cur_pos                 = nullptr;
@@ -272,6 +299,7 @@ public:
     pt_buffer& operator=(pt_buffer&& other) noexcept
     {
         lexy::_detail::swap(_resource, other._resource);
+        lexy::_detail::swap(_sizes, other._sizes);
         lexy::_detail::swap(_head, other._head);
         lexy::_detail::swap(_cur_block, other._cur_block);
         lexy::_detail::swap(_cur_pos, other._cur_pos);
@@ -287,20 +315,29 @@ public:
     void reset()
     {
         if (!_head)
-            _head = block::allocate(_resource);
+            _head = block::allocate(_resource, nullptr, _sizes.initial);
 
         _cur_block = _head;
-        _cur_pos   = &_cur_block->memory[0];
+        _cur_pos   = _cur_block->memory();
     }
 
     void reserve(std::size_t size)
     {
         if (remaining_capacity() < size)
         {
-            auto next        = block::allocate(_resource);
-            _cur_block->next = next;
-            _cur_block       = next;
-            _cur_pos         = &_cur_block->memory[0];
+            // Continue in the next block, re-using one that is still there from before a reset()
+            // or unwind().
+            auto next = _cur_block->next;
+            if (!next)
+            {
+                auto next_size   = _cur_block->size < _sizes.max / 2 ? 2 * _cur_block->size
+                                                                     : _sizes.max;
+                next             = block::allocate(_resource, _cur_block, next_size);
+                _cur_block->next = next;
+            }
+
+            _cur_block = next;
+            _cur_pos   = _cur_block->memory();
         }
     }
 
@@ -317,22 +354,57 @@ public:
         return ::new (static_cast<void*>(memory)) T(LEXY_FWD(args)...);
     }
 
+    // Destroys all nodes allocated at or after the marker, which must be a node.
+    // The blocks after the marker are kept and re-used by subsequent allocations.
     void unwind(void* marker) noexcept
     {
         auto pos = static_cast<unsigned char*>(marker);
 
-        // Note: this is not guaranteed to work by the standard;
-        // We'd have to go through std::less instead.
-        // However, on all implementations I care about, std::less just does < anyway.
-        if (_cur_block->memory <= pos && pos < _cur_block->end())
-            // We're still in the same block, just reset position.
-            _cur_pos = pos;
+        // Go back to the block that contains the marker.
+        // As we're only backtracking a production, it is usually the current one or close to it.
+        while (!_cur_block->contains(pos))
+        {
+            LEXY_PRECONDITION(_cur_block->prev);
+            _cur_block = _cur_block->prev;
+        }
+
+        _cur_pos = pos;
+    }
+
+    //=== memory ===//
+    // The total size of all blocks.
+    std::size_t capacity() const noexcept
+    {
+        auto result = std::size_t(0);
+        for (auto cur = _head; cur != nullptr; cur = cur->next)
+            result += cur->size;
+        return result;
+    }
+
+    // Destroys all nodes and releases all blocks that exceed the capacity.
+    // Must call reset() before allocating again.
+    void trim(std::size_t max_capacity) noexcept
+    {
+        // Keep the longest prefix of blocks that fits into the capacity.
+        auto last     = static_cast<block*>(nullptr);
+        auto capacity = std::size_t(0);
+        for (auto cur = _head; cur != nullptr && capacity + cur->size <= max_capacity;
+             cur      = cur->next)
+        {
+            last = cur;
+            capacity += cur->size;
+        }
+
+        auto cur = last ? last->next : _head;
+        while (cur != nullptr)
+            cur = block::deallocate(_resource, cur);
+
+        if (last)
+            last->next = nullptr;
         else
-            // Reset to the beginning of the current block only.
-            // This can waste memory, but this is not a problem here:
-            // unwind() is only used to backtrack a production, which happens after a couple of
-            // tokens only; the memory waste is directly proportional to the lookahead length.
-            _cur_pos = _cur_block->memory;
+            _head = nullptr;
+        _cur_block = nullptr;
+        _cur_pos   = nullptr;
     }
 
 private:
@@ -342,6 +414,7 @@ private:
     }
 
     LEXY_EMPTY_MEMBER resource_ptr _resource;
+    parse_tree_block_sizes         _sizes;
     block*                         _head;
 
     block*         _cur_block;
@@ -361,7 +434,15 @@ public:
     class builder;
 
     constexpr parse_tree() : parse_tree(_detail::get_memory_resource<MemoryResource>()) {}
-    constexpr explicit parse_tree(MemoryResource* resource) : _buffer(resource), _root(nullptr) {}
+    constexpr explicit parse_tree(MemoryResource* resource)
+    : parse_tree(resource, parse_tree_block_sizes{})
+    {}
+    constexpr explicit parse_tree(parse_tree_block_sizes sizes)
+    : parse_tree(_detail::get_memory_resource<MemoryResource>(), sizes)
+    {}
+    constexpr explicit parse_tree(MemoryResource* resource, parse_tree_block_sizes sizes)
+    : _buffer(resource, sizes), _root(nullptr)
+    {}
 
     //=== container access ===//
     bool empty() const noexcept
@@ -375,6 +456,21 @@ public:
         _root = nullptr;
     }
 
+    //=== memory ===//
+    /// The number of bytes allocated to store the nodes, including memory that is currently
+    /// unused.
+    std::size_t capacity() const noexcept
+    {
+        return _buffer.capacity();
+    }
+
+    /// Clears the tree and releases memory until its capacity is at most `max_capacity`.
+    void trim(std::size_t max_capacity) noexcept
+    {
+        _buffer.trim(max_capacity);
+        _root = nullptr;
+    }
+
     //=== node access ===//
     class node;
     class node_kind;
@@ -1016,6 +1112,122 @@ private:
 };
 } // namespace lexy
 
+//=== parse_tree_pool ===//
+namespace lexy
+{
+/// Keeps the memory of parse trees that are no longer needed to re-use it for new trees.
+template <typename Reader, typename TokenKind = void,
+          typename MemoryResource = _detail::default_memory_resource>
+class parse_tree_pool
+{
+public:
+    using tree_type = parse_tree<Reader, TokenKind, MemoryResource>;
+
+    //=== constructors ===//
+    /// Every tree of the pool uses the block sizes, and retains at most `max_capacity` bytes.
+    /// It must be at least the size of the first block, so a tree can keep that one.
+    explicit parse_tree_pool(MemoryResource* resource, parse_tree_block_sizes sizes = {},
+                             std::size_t max_capacity = std::size_t(-1)) noexcept
+    : _resource(resource), _sizes(sizes), _max_capacity(max_capacity), _trees(nullptr), _size(0),
+      _capacity(0)
+    {
+        LEXY_PRECONDITION(max_capacity >= sizes.initial);
+    }
+    explicit parse_tree_pool(parse_tree_block_sizes sizes = {},
+                             std::size_t max_capacity = std::size_t(-1)) noexcept
+    : parse_tree_pool(_detail::get_memory_resource<MemoryResource>(), sizes, max_capacity)
+    {}
+
+    parse_tree_pool(const parse_tree_pool&) = delete;
+    parse_tree_pool& operator=(const parse_tree_pool&) = delete;
+
+    ~parse_tree_pool() noexcept
+    {
+        for (auto i = std::size_t(0); i != _size; ++i)
+            _trees[i].~tree_type();
+        if (_trees)
+            _resource->deallocate(_trees, _capacity * sizeof(tree_type), alignof(tree_type));
+    }
+
+    //=== access ===//
+    /// The number of trees in the pool.
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// Returns an empty tree, re-using the memory of a previously released one if possible.
+    tree_type acquire()
+    {
+        if (_size == 0)
+            return tree_type(_resource.get(), _sizes);
+
+        --_size;
+        auto result = LEXY_MOV(_trees[_size]);
+        _trees[_size].~tree_type();
+        return result;
+    }
+
+    /// Clears the tree and keeps its memory for subsequent calls to `acquire()`.
+    /// The tree must have been created by the pool.
+    void release(tree_type&& tree)
+    {
+        tree.trim(_max_capacity);
+        if (tree.capacity() == 0)
+            // Nothing left worth keeping.
+            return;
+
+        push(LEXY_MOV(tree));
+    }
+
+    /// Ensures that the pool contains at least `count` trees that have already allocated memory.
+    void reserve(std::size_t count)
+    {
+        while (_size < count)
+        {
+            auto tree = tree_type(_resource.get(), _sizes);
+            tree.clear(); // Allocates the first block.
+            // The first block is within `max_capacity`, so no need to trim it.
+            push(LEXY_MOV(tree));
+        }
+    }
+
+private:
+    void push(tree_type&& tree)
+    {
+        if (_size == _capacity)
+            grow();
+        ::new (static_cast<void*>(_trees + _size)) tree_type(LEXY_MOV(tree));
+        ++_size;
+    }
+
+    void grow()
+    {
+        auto new_capacity = _capacity == 0 ? std::size_t(16) : 2 * _capacity;
+        auto new_trees    = static_cast<tree_type*>(
+            _resource->allocate(new_capacity * sizeof(tree_type), alignof(tree_type)));
+
+        for (auto i = std::size_t(0); i != _size; ++i)
+        {
+            ::new (static_cast<void*>(new_trees + i)) tree_type(LEXY_MOV(_trees[i]));
+            _trees[i].~tree_type();
+        }
+        if (_trees)
+            _resource->deallocate(_trees, _capacity * sizeof(tree_type), alignof(tree_type));
+
+        _trees    = new_trees;
+        _capacity = new_capacity;
+    }
+
+    LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
+    parse_tree_block_sizes                                         _sizes;
+    std::size_t                                                    _max_capacity;
+
+    tree_type*  _trees;
+    std::size_t _size, _capacity;
+};
+} // namespace lexy
+
 //=== parse_as_tree ===//
 namespace lexy
 {
@@ -1047,7 +1259,12 @@ public:
     {
         if (_depth++ == 0)
         {
-            _builder.emplace(LEXY_MOV(*_tree), prod);
+            if constexpr (std::is_constructible_v<typename Tree::builder, Tree&&, Production,
+                                                  Iterator>)
+                // The builder wants to know where the input begins.
+                _builder.emplace(LEXY_MOV(*_tree), prod, pos);
+            else
+                _builder.emplace(LEXY_MOV(*_tree), prod);
             return {{}, pos};
         }
         else
@@ -1091,10 +1308,8 @@ private:
     lexy::validate_handler<Input, Callback> _validate;
 };
 
-template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
-          typename Callback>
-bool parse_as_tree(parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>& tree,
-                   const Input& input, Callback callback)
+template <typename Production, typename Tree, typename Input, typename Callback>
+bool _parse_as_tree(Tree& tree, const Input& input, Callback callback)
 {
     auto                handler = _pt_handler(tree, input, LEXY_MOV(callback));
     auto                reader  = input.reader();
@@ -1103,6 +1318,14 @@ bool parse_as_tree(parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResour
     using rule = lexy::production_rule<Production>;
     return lexy::rule_parser<rule, lexy::context_value_parser>::parse(context, reader);
 }
+
+template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
+          typename Callback>
+bool parse_as_tree(parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>& tree,
+                   const Input& input, Callback callback)
+{
+    return _parse_as_tree<Production>(tree, input, LEXY_MOV(callback));
+}
 } // namespace lexy
 
 #endif // LEXY_PARSE_TREE_HPP_INCLUDED
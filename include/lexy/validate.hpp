@@ -43,6 +43,9 @@ public:
         return pos;
     }
 
+    // All tokens are discarded.
+    static constexpr bool ignores_tokens = true;
+
     template <typename Kind, typename Iterator>
     constexpr void token(Kind, Iterator, Iterator)
     {}
@@ -6,8 +6,158 @@
 #define LEXY_EXT_CFILE_HPP_INCLUDED
 
 #include <cstdio>
-#include <lexy/_detail/buffer_builder.hpp>
+#include <cstring>
 #include <lexy/input/file.hpp>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <sys/stat.h>
+#endif
+
+namespace lexy_ext::_detail
+{
+// The number of bytes left in a regular file, or -1 if it is unknown, e.g. for pipes.
+inline long long cfile_remaining_size(std::FILE* file) noexcept
+{
+#if defined(__unix__) || defined(__APPLE__)
+    // There is no text mode on POSIX, so the size in bytes is the number of characters we'll read.
+    struct ::stat info;
+    if (::fstat(::fileno(file), &info) != 0 || !S_ISREG(info.st_mode))
+        return -1;
+
+    auto pos = std::ftell(file);
+    if (pos < 0 || pos > info.st_size)
+        return -1;
+    return static_cast<long long>(info.st_size - pos);
+#else
+    // We can't use ftell() to get the file size, as the file might not be open in binary mode.
+    (void)file;
+    return -1;
+#endif
+}
+
+// A list of chunks that reads a file of unknown size.
+// Each chunk is bigger than the previous one, and they are only concatenated once at the end.
+class cfile_chunk_list
+{
+    static constexpr std::size_t initial_chunk_size = 4 * 1024;
+    static constexpr std::size_t max_chunk_size     = 1024 * 1024;
+
+public:
+    cfile_chunk_list() noexcept : _head(nullptr), _tail(nullptr), _size(0) {}
+
+    cfile_chunk_list(const cfile_chunk_list&) = delete;
+    cfile_chunk_list& operator=(const cfile_chunk_list&) = delete;
+
+    ~cfile_chunk_list() noexcept
+    {
+        deallocate();
+    }
+
+    // The total number of characters.
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    // Appends a copy of the characters.
+    void append(const char* data, std::size_t size)
+    {
+        auto chunk = allocate(size);
+        std::memcpy(chunk->data(), data, size);
+        chunk->size = size;
+        _size += size;
+    }
+
+    // Reads the rest of the file, returns false on a read error.
+    // The first chunk has the specified capacity.
+    bool read(std::FILE* file, std::size_t capacity = initial_chunk_size)
+    {
+        while (true)
+        {
+            auto chunk  = allocate(capacity);
+            chunk->size = std::fread(chunk->data(), sizeof(char), capacity, file);
+            _size += chunk->size;
+
+            // Check whether we have exhausted the file.
+            if (chunk->size < capacity)
+                return !std::ferror(file);
+
+            capacity = capacity < max_chunk_size ? 2 * capacity : max_chunk_size;
+        }
+    }
+
+    // Copies all characters to dest.
+    void copy(char* dest) const noexcept
+    {
+        for (auto chunk = _head; chunk; chunk = chunk->next)
+        {
+            std::memcpy(dest, chunk->data(), chunk->size);
+            dest += chunk->size;
+        }
+    }
+
+    // Concatenates the chunks, unless all characters are already in the first one.
+    // Returns a pointer to the characters.
+    const char* flatten()
+    {
+        if (!_head)
+            return "";
+        else if (_head->size == _size)
+            return _head->data();
+
+        auto result  = static_cast<chunk*>(::operator new(sizeof(chunk) + _size));
+        result->next = nullptr;
+        result->size = _size;
+        copy(result->data());
+
+        deallocate();
+        _head = _tail = result;
+        return result->data();
+    }
+
+private:
+    struct chunk
+    {
+        chunk*      next;
+        std::size_t size;
+
+        char* data() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    chunk* allocate(std::size_t capacity)
+    {
+        auto result  = static_cast<chunk*>(::operator new(sizeof(chunk) + capacity));
+        result->next = nullptr;
+        result->size = 0;
+
+        if (_tail)
+            _tail->next = result;
+        else
+            _head = result;
+        _tail = result;
+        return result;
+    }
+
+    void deallocate() noexcept
+    {
+        while (_head)
+        {
+            auto next = _head->next;
+            ::operator delete(_head);
+            _head = next;
+        }
+        _tail = nullptr;
+    }
+
+    chunk*      _head;
+    chunk*      _tail;
+    std::size_t _size;
+};
+} // namespace lexy_ext::_detail
 
 namespace lexy_ext
 {
@@ -19,47 +169,70 @@ auto read_file(std::FILE*      file,
                MemoryResource* resource = lexy::_detail::get_memory_resource<MemoryResource>())
     -> lexy::result<lexy::buffer<Encoding, MemoryResource>, lexy::file_error>
 {
+    using buffer_type = lexy::buffer<Encoding, MemoryResource>;
+
     if (!file)
         return {lexy::result_error, lexy::file_error::file_not_found};
     else if (std::ferror(file))
         return {lexy::result_error, lexy::file_error::os_error};
 
-    // We can't use ftell() to get file size, as the file might not be open in binary mode.
-    // So instead use a conservative loop.
-    lexy::_detail::buffer_builder<char> builder;
-    while (true)
-    {
-        const auto buffer_size = builder.write_size();
-        LEXY_ASSERT(buffer_size > 0, "buffer empty?!");
+    // Whether make_buffer_from_raw() copies the contents unchanged, so we can read straight into the
+    // buffer.
+    constexpr auto is_verbatim = sizeof(typename Encoding::char_type) == 1
+                                 && !(std::is_same_v<Encoding, lexy::utf8_encoding>
+                                      && Endian == lexy::encoding_endianness::bom);
 
-        // Read into the entire write area of the buffer from the file,
-        // commiting what we've just read.
-        const auto read = std::fread(builder.write_data(), sizeof(char), buffer_size, file);
-        builder.commit(read);
+    _detail::cfile_chunk_list chunks;
+    if (auto remaining = _detail::cfile_remaining_size(file); remaining < 0)
+    {
+        // We don't know the size, so we need to read chunks.
+        if (!chunks.read(file))
+            return {lexy::result_error, lexy::file_error::os_error};
+    }
+    else if constexpr (is_verbatim)
+    {
+        // We can read the entire file directly into the buffer.
+        auto size = static_cast<std::size_t>(remaining);
 
-        // Check whether we have exhausted the file.
-        if (read < buffer_size)
+        typename buffer_type::builder builder(size, resource);
+        auto read = std::fread(builder.data(), sizeof(char), size, file);
+        if (read == size)
         {
-            if (std::ferror(file))
-                // We have a read error.
-                return {lexy::result_error, lexy::file_error::os_error};
-
-            // We should have reached the end of the file.
-            LEXY_ASSERT(std::feof(file), "why did fread() not read enough?");
-            break;
+            auto c = std::fgetc(file);
+            if (c == EOF && !std::ferror(file))
+                return {lexy::result_value, LEXY_MOV(builder).finish()};
+            else if (c != EOF)
+                std::ungetc(c, file);
         }
+        if (std::ferror(file))
+            return {lexy::result_error, lexy::file_error::os_error};
 
-        // We've filled the entire buffer and need more space.
-        // This grow might be unnecessary if we're just so happen to reach EOF with the next
-        // input, but checking this requires reading more input.
-        builder.grow();
+        // The file has been changed while we were reading it, so we read the rest into chunks.
+        chunks.append(reinterpret_cast<const char*>(builder.data()), read);
+        if (!chunks.read(file))
+            return {lexy::result_error, lexy::file_error::os_error};
+    }
+    else
+    {
+        // We read the entire file into a single chunk, so we can convert it from there.
+        // The additional character lets us detect EOF without another read.
+        if (!chunks.read(file, static_cast<std::size_t>(remaining) + 1))
+            return {lexy::result_error, lexy::file_error::os_error};
     }
 
-    auto buffer = lexy::make_buffer_from_raw<Encoding, Endian>(builder.read_data(),
-                                                               builder.read_size(), resource);
-    return {lexy::result_value, LEXY_MOV(buffer)};
+    if constexpr (is_verbatim)
+    {
+        typename buffer_type::builder builder(chunks.size(), resource);
+        chunks.copy(reinterpret_cast<char*>(builder.data()));
+        return {lexy::result_value, LEXY_MOV(builder).finish()};
+    }
+    else
+    {
+        auto data   = chunks.flatten();
+        auto buffer = lexy::make_buffer_from_raw<Encoding, Endian>(data, chunks.size(), resource);
+        return {lexy::result_value, LEXY_MOV(buffer)};
+    }
 }
 } // namespace lexy_ext
 
 #endif // LEXY_EXT_CFILE_HPP_INCLUDED
-
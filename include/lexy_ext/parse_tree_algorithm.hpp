@@ -5,8 +5,10 @@
 #ifndef LEXY_EXT_PARSE_TREE_ALGORITHM_HPP_INCLUDED
 #define LEXY_EXT_PARSE_TREE_ALGORITHM_HPP_INCLUDED
 
+#include <iterator>
 #include <lexy/parse_tree.hpp>
 #include <optional>
+#include <vector>
 
 namespace lexy_ext
 {
@@ -145,6 +147,7 @@ namespace lexy_ext
 {
 /// Returns the node of the tree that covers the position.
 /// It is always a token.
+/// This is a linear search; use `lexy_ext::token_index` for repeated queries.
 template <typename Reader, typename TokenKind, typename MemoryResource>
 auto find_covering_node(const lexy::parse_tree<Reader, TokenKind, MemoryResource>& tree,
                         typename Reader::iterator                                  position) ->
@@ -167,6 +170,282 @@ auto find_covering_node(const lexy::parse_tree<Reader, TokenKind, MemoryResource
 }
 } // namespace lexy_ext
 
+namespace lexy_ext::_detail
+{
+// Maps the address of a node to an index using an open addressing hash table.
+class node_table
+{
+public:
+    explicit node_table(std::size_t count = 0)
+    {
+        // Size the table for a load factor of at most 1/2.
+        auto size = std::size_t(1);
+        while (size < 2 * count)
+            size *= 2;
+        _table.resize(size);
+    }
+
+    void insert(const void* node, std::size_t value) noexcept
+    {
+        auto idx = _hash(node);
+        while (_table[idx].node != nullptr)
+            idx = (idx + 1) & (_table.size() - 1);
+        _table[idx] = {node, value};
+    }
+
+    std::size_t find(const void* node) const noexcept
+    {
+        auto idx = _hash(node);
+        while (_table[idx].node != node)
+        {
+            LEXY_PRECONDITION(_table[idx].node != nullptr); // Node not part of the tree.
+            idx = (idx + 1) & (_table.size() - 1);
+        }
+        return _table[idx].value;
+    }
+
+private:
+    struct _entry
+    {
+        const void* node  = nullptr;
+        std::size_t value = 0;
+    };
+
+    std::size_t _hash(const void* node) const noexcept
+    {
+        // Nodes are allocated sequentially, so multiplying by an odd number spreads them evenly.
+        auto value = reinterpret_cast<std::uintptr_t>(node) / alignof(void*);
+        return std::size_t(value * 0x9E3779B1u) & (_table.size() - 1);
+    }
+
+    std::vector<_entry> _table;
+};
+} // namespace lexy_ext::_detail
+
+namespace lexy_ext
+{
+/// An index that gives constant-time access to the parent of a node.
+///
+/// `node.parent()` is linear in the number of siblings that follow the node.
+/// The index stores the parent of every node that is not the last child of its parent in a hash
+/// table; it needs between `4 * sizeof(void*)` and `8 * sizeof(void*)` bytes for each such node.
+/// It is built once in linear time and must not outlive the tree or be used after it changes.
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class parent_index
+{
+    using node_t = typename lexy::parse_tree<Reader, TokenKind, MemoryResource>::node;
+
+public:
+    explicit parent_index(const lexy::parse_tree<Reader, TokenKind, MemoryResource>& tree)
+    {
+        if (tree.empty())
+            return;
+
+        auto count = std::size_t(0);
+        for (auto [event, node] : tree.traverse())
+            if (event != lexy::traverse_event::exit && !node.kind().is_root()
+                && !node.is_last_child())
+                ++count;
+        _table = _detail::node_table(count);
+
+        for (auto [event, node] : tree.traverse())
+        {
+            if (event != lexy::traverse_event::enter || node.children().size() <= 1)
+                continue;
+
+            auto parent = _parents.size();
+            _parents.push_back(node);
+            for (auto child : node.children())
+                if (!child.is_last_child())
+                    _table.insert(child.address(), parent);
+        }
+    }
+
+    /// Returns the same node as `node.parent()`, but in constant time.
+    node_t parent(node_t node) const noexcept
+    {
+        if (node.kind().is_root() || node.is_last_child())
+            // The node directly points to its parent.
+            return node.parent();
+        else
+            return _parents[_table.find(node.address())];
+    }
+
+private:
+    _detail::node_table _table;
+    std::vector<node_t> _parents;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+parent_index(const lexy::parse_tree<Reader, TokenKind, MemoryResource>&)
+    -> parent_index<Reader, TokenKind, MemoryResource>;
+} // namespace lexy_ext
+
+namespace lexy_ext
+{
+/// An index of all tokens of a tree sorted by position that answers position queries in
+/// logarithmic time.
+///
+/// It stores a node and an iterator for every token, and a hash table entry for every production.
+/// It is built once in linear time and must not outlive the tree or be used after it changes.
+/// The iterators of the input must be random access, as positions are compared with `<`.
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class token_index
+{
+    using node_t = typename lexy::parse_tree<Reader, TokenKind, MemoryResource>::node;
+
+public:
+    using iterator = typename Reader::iterator;
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<iterator>::iterator_category>,
+                  "token_index requires random access iterators");
+
+    explicit token_index(const lexy::parse_tree<Reader, TokenKind, MemoryResource>& tree)
+    {
+        if (tree.empty())
+            return;
+
+        auto production_count = std::size_t(0);
+        for (auto [event, node] : tree.traverse())
+            if (event == lexy::traverse_event::enter)
+                ++production_count;
+        _first_token = _detail::node_table(production_count);
+
+        // As the tree is traversed in order, the first token after entering a production is its
+        // first token, if it has one at all.
+        std::vector<const void*> pending;
+        for (auto [event, node] : tree.traverse())
+        {
+            if (event == lexy::traverse_event::enter)
+                pending.push_back(node.address());
+            else if (event == lexy::traverse_event::exit)
+            {
+                if (!pending.empty() && pending.back() == node.address())
+                {
+                    // The production doesn't have any tokens.
+                    _first_token.insert(node.address(), std::size_t(-1));
+                    pending.pop_back();
+                }
+            }
+            else
+            {
+                for (auto prod : pending)
+                    _first_token.insert(prod, _tokens.size());
+                pending.clear();
+
+                _tokens.push_back(node);
+                _ends.push_back(node.lexeme().end());
+            }
+        }
+    }
+
+    /// The number of tokens in the tree.
+    std::size_t size() const noexcept
+    {
+        return _tokens.size();
+    }
+
+    /// Same as `lexy_ext::node_position()`, but in constant time.
+    iterator node_position(node_t node) const noexcept
+    {
+        if (node.kind().is_token())
+            return node.lexeme().begin();
+
+        auto idx = _first_token.find(node.address());
+        if (idx == std::size_t(-1))
+            return {};
+        else
+            return _tokens[idx].lexeme().begin();
+    }
+
+    /// Same as `lexy_ext::find_covering_node()`, but in logarithmic time.
+    node_t find_covering_node(iterator position) const noexcept
+    {
+        auto idx = _first_ending_after(position);
+        LEXY_PRECONDITION(idx < _tokens.size()); // Position out of bounds.
+        return _tokens[idx];
+    }
+
+    class token_range
+    {
+    public:
+        using iterator = const node_t*;
+
+        bool empty() const noexcept
+        {
+            return _begin == _end;
+        }
+        std::size_t size() const noexcept
+        {
+            return std::size_t(_end - _begin);
+        }
+
+        iterator begin() const noexcept
+        {
+            return _begin;
+        }
+        iterator end() const noexcept
+        {
+            return _end;
+        }
+
+    private:
+        explicit token_range(iterator begin, iterator end) noexcept : _begin(begin), _end(end) {}
+
+        iterator _begin, _end;
+
+        friend token_index;
+    };
+
+    /// Returns all tokens that overlap the range `[begin, end)`, in order.
+    token_range tokens(iterator begin, iterator end) const noexcept
+    {
+        if (begin == end)
+            // An empty range doesn't overlap anything, even if it is inside a token.
+            return token_range(_tokens.data(), _tokens.data());
+
+        // The first token that ends after the beginning of the range.
+        auto first = _first_ending_after(begin);
+
+        // The first token that begins at or after the end of the range.
+        auto lo = first, hi = _tokens.size();
+        while (lo < hi)
+        {
+            auto mid = lo + (hi - lo) / 2;
+            if (_tokens[mid].lexeme().begin() < end)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        return token_range(_tokens.data() + first, _tokens.data() + lo);
+    }
+
+private:
+    std::size_t _first_ending_after(iterator position) const noexcept
+    {
+        auto lo = std::size_t(0), hi = _ends.size();
+        while (lo < hi)
+        {
+            auto mid = lo + (hi - lo) / 2;
+            if (!(position < _ends[mid]))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    std::vector<node_t>   _tokens;
+    std::vector<iterator> _ends;
+    _detail::node_table   _first_token;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+token_index(const lexy::parse_tree<Reader, TokenKind, MemoryResource>&)
+    -> token_index<Reader, TokenKind, MemoryResource>;
+} // namespace lexy_ext
+
 namespace lexy_ext
 {
 template <typename Predicate, typename Iterator, typename Sentinel>
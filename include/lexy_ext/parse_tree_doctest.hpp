@@ -8,6 +8,7 @@
 #include <cctype>
 #include <cstdio>
 #include <doctest/doctest.h>
+#include <lexy/compact_parse_tree.hpp>
 #include <lexy/parse_tree.hpp>
 
 namespace lexy_ext
@@ -119,6 +120,23 @@ public:
         return toString(desc) == string_maker::convert(tree);
     }
 
+    template <typename Reader, typename MemoryResource>
+    friend bool operator==(const parse_tree_desc&                                             desc,
+                           const lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>& tree)
+    {
+        using string_maker
+            = doctest::StringMaker<lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>>;
+        return toString(desc) == string_maker::convert(tree);
+    }
+    template <typename Reader, typename MemoryResource>
+    friend bool operator==(const lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>& tree,
+                           const parse_tree_desc&                                             desc)
+    {
+        using string_maker
+            = doctest::StringMaker<lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>>;
+        return toString(desc) == string_maker::convert(tree);
+    }
+
 private:
     void prefix()
     {
@@ -139,6 +157,34 @@ private:
 };
 } // namespace lexy_ext
 
+namespace lexy_ext
+{
+template <typename TokenKind, typename Tree>
+doctest::String _parse_tree_to_string(const Tree& tree)
+{
+    lexy_ext::parse_tree_desc<TokenKind> builder;
+
+    for (auto [event, node] : tree.traverse())
+        switch (event)
+        {
+        case lexy::traverse_event::enter:
+            builder.production(node.kind().name());
+            break;
+        case lexy::traverse_event::exit:
+            builder.finish();
+            break;
+
+        case lexy::traverse_event::leaf: {
+            auto token = node.token();
+            builder.token(token.kind(), token.lexeme().begin(), token.lexeme().end());
+            break;
+        }
+        }
+
+    return toString(builder);
+}
+} // namespace lexy_ext
+
 namespace doctest
 {
 template <typename Reader, typename TokenKind, typename MemoryResource>
@@ -148,26 +194,18 @@ struct StringMaker<lexy::parse_tree<Reader, TokenKind, MemoryResource>>
 
     static String convert(const parse_tree& tree)
     {
-        lexy_ext::parse_tree_desc<TokenKind> builder;
+        return lexy_ext::_parse_tree_to_string<TokenKind>(tree);
+    }
+};
 
-        for (auto [event, node] : tree.traverse())
-            switch (event)
-            {
-            case lexy::traverse_event::enter:
-                builder.production(node.kind().name());
-                break;
-            case lexy::traverse_event::exit:
-                builder.finish();
-                break;
-
-            case lexy::traverse_event::leaf: {
-                auto token = node.token();
-                builder.token(token.kind(), token.lexeme().begin(), token.lexeme().end());
-                break;
-            }
-            }
+template <typename Reader, typename TokenKind, typename MemoryResource>
+struct StringMaker<lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>>
+{
+    using parse_tree = lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>;
 
-        return toString(builder);
+    static String convert(const parse_tree& tree)
+    {
+        return lexy_ext::_parse_tree_to_string<TokenKind>(tree);
     }
 };
 } // namespace doctest
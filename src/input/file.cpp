@@ -4,6 +4,13 @@
 
 #include <lexy/input/file.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #if defined(__unix__) || defined(__APPLE__)
 
 #    include <cerrno>
@@ -105,6 +112,62 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     return lexy::file_error::_success;
 }
 
+lexy::file_error lexy::_detail::map_file(const char* path, const char*& memory, std::size_t& size)
+{
+    raii_fd fd(::open(path, O_RDONLY));
+    if (fd < 0)
+        return get_file_error();
+
+    auto off = ::lseek(fd, 0, SEEK_END);
+    if (off == static_cast<::off_t>(-1))
+        return lexy::file_error::os_error;
+    size = static_cast<std::size_t>(off);
+
+    if (size == 0)
+    {
+        // We can't map an empty file.
+        memory = nullptr;
+        return lexy::file_error::_success;
+    }
+
+    // The mapping stays valid after the file has been closed.
+    auto result = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (result == MAP_FAILED)
+        return lexy::file_error::os_error;
+
+    memory = static_cast<const char*>(result);
+    return lexy::file_error::_success;
+}
+
+void lexy::_detail::unmap_file(const char* memory, std::size_t size) noexcept
+{
+    ::munmap(const_cast<char*>(memory), size);
+}
+
+void lexy::_detail::advise_file(const char* memory, std::size_t size,
+                                lexy::file_advice advice) noexcept
+{
+    auto flag = POSIX_MADV_NORMAL;
+    switch (advice)
+    {
+    case lexy::file_advice::normal:
+        flag = POSIX_MADV_NORMAL;
+        break;
+    case lexy::file_advice::sequential:
+        flag = POSIX_MADV_SEQUENTIAL;
+        break;
+    case lexy::file_advice::random:
+        flag = POSIX_MADV_RANDOM;
+        break;
+    case lexy::file_advice::will_need:
+        flag = POSIX_MADV_WILLNEED;
+        break;
+    }
+
+    // It's just a hint, so we can ignore errors.
+    ::posix_madvise(const_cast<char*>(memory), size, flag);
+}
+
 #else
 
 #    include <cerrno>
@@ -184,5 +247,134 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     return file_error::_success;
 }
 
+lexy::file_error lexy::_detail::map_file(const char* path, const char*& memory, std::size_t& size)
+{
+    // We can't map the file, so we read it into memory instead.
+    raii_file file(std::fopen(path, "rb"));
+    if (!file)
+        return get_file_error();
+
+    if (std::fseek(file, 0, SEEK_END) != 0)
+        return lexy::file_error::os_error;
+
+    auto file_size = std::ftell(file);
+    if (file_size == -1)
+        return lexy::file_error::os_error;
+
+    if (std::fseek(file, 0, SEEK_SET) != 0)
+        return lexy::file_error::os_error;
+
+    size = std::size_t(file_size);
+    if (size == 0)
+    {
+        memory = nullptr;
+        return lexy::file_error::_success;
+    }
+
+    auto data = new char[size];
+    if (std::fread(data, sizeof(char), size, file) != size)
+    {
+        delete[] data;
+        return lexy::file_error::os_error;
+    }
+
+    memory = data;
+    return lexy::file_error::_success;
+}
+
+void lexy::_detail::unmap_file(const char* memory, std::size_t) noexcept
+{
+    delete[] memory;
+}
+
+void lexy::_detail::advise_file(const char*, std::size_t, lexy::file_advice) noexcept {}
+
 #endif
 
+namespace
+{
+// The number of files a thread claims at once.
+constexpr std::size_t file_batch_size = 8;
+} // namespace
+
+void lexy::_detail::read_files(const char* const* paths, std::size_t count,
+                               std::size_t thread_count, file_batch_callback cb, void* user_data)
+{
+    if (thread_count == 0)
+        thread_count = std::thread::hardware_concurrency();
+    // It's not worth starting a thread without a full batch of files.
+    thread_count = std::min(thread_count, (count + file_batch_size - 1) / file_batch_size);
+    if (thread_count == 0)
+        thread_count = 1;
+
+    // The first exception, which is rethrown at the end.
+    std::exception_ptr exception;
+    std::mutex         exception_mutex;
+    auto               store_exception = [&] {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!exception)
+            exception = std::current_exception();
+    };
+
+    std::atomic<std::size_t> next(0);
+    auto                     worker = [&] {
+        while (true)
+        {
+            auto begin = next.fetch_add(file_batch_size, std::memory_order_relaxed);
+            if (begin >= count)
+                break;
+
+            auto end = std::min(begin + file_batch_size, count);
+            for (auto index = begin; index != end; ++index)
+            {
+                struct file_data_t
+                {
+                    file_batch_callback cb;
+                    void*               user_data;
+                    std::size_t         index;
+                } file_data{cb, user_data, index};
+
+                auto error = file_error::_success;
+                try
+                {
+                    error = read_file(
+                        paths[index],
+                        [](void* _file_data, const char* memory, std::size_t size) {
+                            auto file_data = static_cast<file_data_t*>(_file_data);
+                            file_data->cb(file_data->user_data, file_data->index,
+                                          file_error::_success, memory, size);
+                        },
+                        &file_data);
+                }
+                catch (...)
+                {
+                    // Either reading the file or the callback failed before storing the result.
+                    store_exception();
+                    error = file_error::os_error;
+                }
+
+                if (error != file_error::_success)
+                    cb(user_data, index, error, nullptr, 0);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    try
+    {
+        threads.reserve(thread_count - 1);
+        for (auto i = std::size_t(1); i != thread_count; ++i)
+            threads.emplace_back(worker);
+    }
+    catch (...)
+    {
+        // We can't start more threads, so we do with the ones we have.
+    }
+
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
@@ -359,3 +359,12 @@ TEST_CASE("as_integer")
     CHECK(sign == -42);
 }
 
+TEST_CASE("as_float")
+{
+    double no_sign = lexy::as_float<double>(0.5);
+    CHECK(no_sign == 0.5);
+
+    double sign = lexy::as_float<double>(-1, 0.5);
+    CHECK(sign == -0.5);
+}
+
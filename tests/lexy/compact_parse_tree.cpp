@@ -0,0 +1,424 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/compact_parse_tree.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/brackets.hpp>
+#include <lexy/dsl/delimited.hpp>
+#include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/production.hpp>
+#include <lexy/dsl/sequence.hpp>
+#include <lexy/dsl/whitespace.hpp>
+#include <lexy/input/string_input.hpp>
+#include <lexy_ext/parse_tree_doctest.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+enum class token_kind
+{
+    a,
+    b,
+    c,
+};
+
+const char* token_kind_name(token_kind k)
+{
+    switch (k)
+    {
+    case token_kind::a:
+        return "a";
+    case token_kind::b:
+        return "b";
+    case token_kind::c:
+        return "c";
+    }
+
+    return "";
+}
+
+struct string_p : lexy::token_production
+{
+    static constexpr auto name = "string_p";
+    static constexpr auto rule = lexy::dsl::quoted(lexy::dsl::ascii::character);
+};
+
+struct child_p
+{
+    static constexpr auto name = "child_p";
+    static constexpr auto rule
+        = lexy::dsl::p<string_p> | lexy::dsl::parenthesized(LEXY_LIT("abc").kind<token_kind::c>);
+};
+
+struct root_p
+{
+    static constexpr auto name       = "root_p";
+    static constexpr auto whitespace = lexy::dsl::ascii::space;
+
+    static constexpr auto rule = [] {
+        auto digits = lexy::dsl::digits<>.kind<token_kind::a>;
+        return digits + lexy::dsl::p<child_p> + digits;
+    }();
+};
+} // namespace
+
+template <>
+constexpr auto lexy::token_kind_map_for<
+    token_kind> = lexy::token_kind_map.map<::token_kind::b>(lexy::dsl::parenthesized.open())
+                      .map<::token_kind::b>(lexy::dsl::parenthesized.close())
+                      .map<::token_kind::b>(lexy::dsl::quoted.open())
+                      .map<::token_kind::c>(lexy::dsl::ascii::character);
+
+TEST_CASE("compact_parse_tree::builder")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    CHECK(sizeof(lexy::_detail::pt_compact_node) == 12);
+
+    SUBCASE("basic")
+    {
+        auto input = lexy::zstring_input("123(abc)321");
+
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.begin());
+            builder.token(token_kind::a, input.begin(), input.begin() + 3);
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+            builder.token(token_kind::b, input.begin() + 7, input.begin() + 8);
+            builder.finish_production(LEXY_MOV(child));
+
+            builder.token(token_kind::a, input.begin() + 8, input.end());
+
+            return LEXY_MOV(builder).finish();
+        }();
+        CHECK(!tree.empty());
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .token(token_kind::b, "(")
+                .token(token_kind::c, "abc")
+                .token(token_kind::b, ")")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+    }
+    SUBCASE("only root")
+    {
+        auto input = lexy::zstring_input("");
+        auto tree  = parse_tree::builder(root_p{}, input.begin()).finish();
+        CHECK(!tree.empty());
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{});
+        CHECK(tree == expected);
+    }
+    SUBCASE("empty child production")
+    {
+        auto input = lexy::zstring_input("123321");
+
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.begin());
+            builder.token(token_kind::a, input.begin(), input.begin() + 3);
+
+            auto child = builder.start_production(child_p{});
+            builder.finish_production(LEXY_MOV(child));
+
+            builder.token(token_kind::a, input.begin() + 3, input.end());
+
+            return LEXY_MOV(builder).finish();
+        }();
+        CHECK(!tree.empty());
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .token(token_kind::a, "123")
+                            .production(child_p{})
+                            .finish()
+                            .token(token_kind::a, "321");
+        CHECK(tree == expected);
+    }
+    SUBCASE("token production")
+    {
+        auto input = lexy::zstring_input("abc");
+
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.begin());
+
+            auto child = builder.start_production(string_p{});
+            builder.token(token_kind::c, input.begin(), input.begin() + 1);
+            builder.token(token_kind::c, input.begin() + 1, input.begin() + 2);
+            builder.token(token_kind::c, input.begin() + 2, input.end());
+            builder.finish_production(LEXY_MOV(child));
+
+            return LEXY_MOV(builder).finish();
+        }();
+        CHECK(!tree.empty());
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .production(string_p{})
+                            .token(token_kind::c, "abc")
+                            .finish();
+        CHECK(tree == expected);
+    }
+    SUBCASE("backtracking")
+    {
+        auto input = lexy::zstring_input("123(abc)321");
+
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.begin());
+            builder.token(token_kind::a, input.begin(), input.begin() + 3);
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+            auto nested = builder.start_production(string_p{});
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+            builder.backtrack_production(LEXY_MOV(nested));
+            builder.backtrack_production(LEXY_MOV(child));
+
+            child = builder.start_production(child_p{});
+            builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+            builder.token(token_kind::b, input.begin() + 7, input.begin() + 8);
+            builder.finish_production(LEXY_MOV(child));
+
+            builder.token(token_kind::a, input.begin() + 8, input.end());
+
+            return LEXY_MOV(builder).finish();
+        }();
+        CHECK(!tree.empty());
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .token(token_kind::b, "(")
+                .token(token_kind::c, "abc")
+                .token(token_kind::b, ")")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+    }
+
+    constexpr auto many_count = 1024u;
+    SUBCASE("many nested productions")
+    {
+        auto input = lexy::zstring_input("abc");
+
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.begin());
+
+            std::vector<parse_tree::builder::production_state> states;
+            for (auto i = 0u; i != many_count; ++i)
+            {
+                auto state = builder.start_production(child_p{});
+                states.push_back(LEXY_MOV(state));
+            }
+            builder.token(token_kind::a, input.begin(), input.end());
+            for (auto i = 0u; i != many_count; ++i)
+            {
+                builder.finish_production(LEXY_MOV(states.back()));
+                states.pop_back();
+            }
+
+            return LEXY_MOV(builder).finish();
+        }();
+        CHECK(!tree.empty());
+
+        auto expected = [&] {
+            lexy_ext::parse_tree_desc<token_kind> result(root_p{});
+            for (auto i = 0u; i != many_count; ++i)
+                result.production(child_p{});
+            result.token(token_kind::a, "abc");
+            return result;
+        }();
+        CHECK(tree == expected);
+    }
+}
+
+TEST_CASE("compact_parse_tree::node")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("123(abc)321");
+
+    auto tree = [&] {
+        parse_tree::builder builder(root_p{}, input.begin());
+        builder.token(token_kind::a, input.begin(), input.begin() + 3);
+
+        auto child = builder.start_production(child_p{});
+        builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+        builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+        builder.token(token_kind::b, input.begin() + 7, input.begin() + 8);
+        builder.finish_production(LEXY_MOV(child));
+
+        builder.token(token_kind::a, input.begin() + 8, input.end());
+
+        child = builder.start_production(child_p{});
+        builder.finish_production(LEXY_MOV(child));
+
+        return LEXY_MOV(builder).finish();
+    }();
+    REQUIRE(!tree.empty());
+
+    auto root = tree.root();
+    CHECK(root.kind().is_root());
+    CHECK(root.kind() == root_p{});
+    CHECK(root.kind().name() == lexy::_detail::string_view("root_p"));
+    CHECK(root.parent() == root);
+    CHECK(root.siblings().empty());
+    CHECK(root.lexeme().empty());
+    CHECK(root.children().size() == 4);
+
+    std::vector<parse_tree::node> children;
+    for (auto child : root.children())
+        children.push_back(child);
+    REQUIRE(children.size() == 4);
+
+    CHECK(children[0].kind() == token_kind::a);
+    CHECK(children[0].lexeme().begin() == input.begin());
+    CHECK(children[0].lexeme().end() == input.begin() + 3);
+    CHECK(children[0].token().kind() == token_kind::a);
+    CHECK(children[0].children().empty());
+
+    CHECK(children[1].kind() == child_p{});
+    CHECK(children[1].kind() != root_p{});
+    CHECK(children[1].kind() == children[3].kind());
+    CHECK(children[1].kind() != children[0].kind());
+    CHECK(children[1].children().size() == 3);
+
+    CHECK(children[2].kind() == token_kind::a);
+    CHECK(children[2].kind() == children[0].kind());
+    CHECK(children[2].lexeme().begin() == input.begin() + 8);
+    CHECK(children[2].lexeme().end() == input.end());
+
+    CHECK(children[3].kind() == child_p{});
+    CHECK(children[3].children().empty());
+    CHECK(children[3].is_last_child());
+    CHECK(!children[2].is_last_child());
+
+    // Kinds compare equal across trees, even if the names were interned in a different order.
+    auto other = parse_tree::builder(child_p{}, input.begin()).finish();
+    CHECK(other.root().kind() == children[1].kind());
+    CHECK(other.root().kind() != root.kind());
+
+    for (auto child : children)
+        CHECK(child.parent() == root);
+    for (auto grandchild : children[1].children())
+    {
+        CHECK(grandchild.kind().is_token());
+        CHECK(grandchild.parent() == children[1]);
+    }
+
+    std::vector<parse_tree::node> siblings(children[1].siblings().begin(),
+                                           children[1].siblings().end());
+    REQUIRE(siblings.size() == 3);
+    CHECK(siblings[0] == children[2]);
+    CHECK(siblings[1] == children[3]);
+    CHECK(siblings[2] == children[0]);
+
+    SUBCASE("traverse")
+    {
+        std::string events;
+        for (auto [event, node] : tree.traverse())
+        {
+            switch (event)
+            {
+            case lexy::traverse_event::enter:
+                events += "(";
+                break;
+            case lexy::traverse_event::exit:
+                events += ")";
+                break;
+            case lexy::traverse_event::leaf:
+                events += std::string(node.lexeme().begin(), node.lexeme().end());
+                break;
+            }
+        }
+        CHECK(events == "(123((abc))321())");
+    }
+    SUBCASE("traverse child")
+    {
+        std::string events;
+        for (auto [event, node] : tree.traverse(children[1]))
+        {
+            if (event == lexy::traverse_event::leaf)
+                events += std::string(node.lexeme().begin(), node.lexeme().end());
+            else
+                events += event == lexy::traverse_event::enter ? "(" : ")";
+        }
+        CHECK(events == "((abc))");
+    }
+    SUBCASE("traverse token")
+    {
+        auto range = tree.traverse(children[0]);
+        auto iter  = range.begin();
+        CHECK(iter->event == lexy::traverse_event::leaf);
+        CHECK(iter->node == children[0]);
+        ++iter;
+        CHECK(iter == range.end());
+    }
+}
+
+TEST_CASE("parse_as_tree compact")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    parse_tree tree;
+
+    SUBCASE("quoted")
+    {
+        auto input  = lexy::zstring_input("123\"abc\"321");
+        auto result = lexy::parse_as_tree<root_p>(tree, input, lexy::noop);
+        CHECK(result);
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .production(string_p{})
+                    .token(token_kind::b, "\"")
+                    .token(token_kind::c, "abc")
+                    .token(token_kind::b, "\"")
+                    .finish()
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+    }
+    SUBCASE("whitespace")
+    {
+        auto input  = lexy::zstring_input("123 ( abc ) 321");
+        auto result = lexy::parse_as_tree<root_p>(tree, input, lexy::noop);
+        CHECK(result);
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .token(" ")
+            .production(child_p{})
+                .token(token_kind::b, "(")
+                .token(" ")
+                .token(token_kind::c, "abc")
+                .token(" ")
+                .token(token_kind::b, ")")
+                .token(" ")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+    }
+    SUBCASE("failure")
+    {
+        auto input  = lexy::zstring_input("123(abc");
+        auto result = lexy::parse_as_tree<root_p>(tree, input, lexy::noop);
+        CHECK(!result);
+        CHECK(tree.empty());
+    }
+}
+
@@ -116,3 +116,19 @@ TEST_CASE("_detail::buffer_builder::stable_iterator")
     CHECK(iter == end);
 }
 
+TEST_CASE("_detail::buffer_builder<int>")
+{
+    lexy::_detail::buffer_builder<int> buffer;
+    for (auto i = 0; i != 1000; ++i)
+    {
+        if (buffer.write_size() == 0)
+            buffer.grow();
+
+        *buffer.write_data() = i;
+        buffer.commit(1);
+    }
+
+    REQUIRE(buffer.read_size() == 1000);
+    for (auto i = 0; i != 1000; ++i)
+        REQUIRE(buffer.read_data()[i] == i);
+}
@@ -0,0 +1,311 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/_detail/simd.hpp>
+
+#include <doctest/doctest.h>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Returns the index of the first byte of a string consisting of `size` times `fill` and a `needle`
+// at position `pos`.
+template <typename Fn>
+std::size_t find_in(Fn fn, unsigned char fill, std::size_t size, std::size_t pos,
+                    unsigned char needle)
+{
+    unsigned char buffer[128];
+    for (auto i = 0u; i != size; ++i)
+        buffer[i] = fill;
+    if (pos < size)
+        buffer[pos] = needle;
+
+    return std::size_t(fn(buffer, buffer + size) - buffer);
+}
+} // namespace
+
+TEST_CASE("_detail::swar")
+{
+    auto word = lexy::_detail::swar_int(0x00'01'7F'80'81'FE'FF'40);
+
+    CHECK(lexy::_detail::swar_eq(word, 0x00) == 0x80'00'00'00'00'00'00'00);
+    CHECK(lexy::_detail::swar_eq(word, 0x80) == 0x00'00'00'80'00'00'00'00);
+    CHECK(lexy::_detail::swar_eq(word, 0xFF) == 0x00'00'00'00'00'00'80'00);
+    CHECK(lexy::_detail::swar_eq(word, 0x42) == 0);
+
+    CHECK(lexy::_detail::swar_gt(word, 0x00) == 0x00'80'80'80'80'80'80'80);
+    CHECK(lexy::_detail::swar_gt(word, 0x7F) == 0x00'00'00'80'80'80'80'00);
+    CHECK(lexy::_detail::swar_gt(word, 0x80) == 0x00'00'00'00'80'80'80'00);
+    CHECK(lexy::_detail::swar_gt(word, 0xFE) == 0x00'00'00'00'00'00'80'00);
+    CHECK(lexy::_detail::swar_gt(word, 0xFF) == 0);
+
+    CHECK(lexy::_detail::swar_sub(word, lexy::_detail::swar_fill(1))
+          == 0xFF'00'7E'7F'80'FD'FE'3F);
+}
+
+TEST_CASE("_detail::swar_parse")
+{
+    auto load = [](const char* str) {
+        return lexy::_detail::swar_load_le(reinterpret_cast<const unsigned char*>(str));
+    };
+
+    CHECK(lexy::_detail::swar_parse_decimal8(load("00000000")) == 0);
+    CHECK(lexy::_detail::swar_parse_decimal8(load("00000001")) == 1);
+    CHECK(lexy::_detail::swar_parse_decimal8(load("12345678")) == 12345678);
+    CHECK(lexy::_detail::swar_parse_decimal8(load("90000009")) == 90000009);
+    CHECK(lexy::_detail::swar_parse_decimal8(load("99999999")) == 99999999);
+
+    CHECK(lexy::_detail::swar_is_decimal8(load("01234567")));
+    CHECK(lexy::_detail::swar_is_decimal8(load("99999999")));
+    CHECK(!lexy::_detail::swar_is_decimal8(load("1234567.")));
+    CHECK(!lexy::_detail::swar_is_decimal8(load("/1234567")));
+    CHECK(!lexy::_detail::swar_is_decimal8(load("123:4567")));
+    CHECK(!lexy::_detail::swar_is_decimal8(load("1234\xFF" "567")));
+
+    CHECK(lexy::_detail::swar_parse_hex8(load("00000000")) == 0);
+    CHECK(lexy::_detail::swar_parse_hex8(load("0000000f")) == 0xF);
+    CHECK(lexy::_detail::swar_parse_hex8(load("12345678")) == 0x12345678);
+    CHECK(lexy::_detail::swar_parse_hex8(load("9aBcDeF0")) == 0x9ABCDEF0);
+    CHECK(lexy::_detail::swar_parse_hex8(load("FFFFffff")) == 0xFFFFFFFF);
+}
+
+TEST_CASE("_detail::byte_class")
+{
+    using digit_or_high = lexy::_detail::byte_class<lexy::_detail::byte_range<'0', '9'>,
+                                                    lexy::_detail::byte_range<0xF0, 0xFF>>;
+    CHECK(digit_or_high::contains('0'));
+    CHECK(digit_or_high::contains('5'));
+    CHECK(digit_or_high::contains(0xF0));
+    CHECK(digit_or_high::contains(0xFF));
+    CHECK(!digit_or_high::contains('a'));
+    CHECK(!digit_or_high::contains(0x80));
+
+    SUBCASE("find")
+    {
+        auto find = [](auto begin, auto end) { return digit_or_high::find(begin, end); };
+        for (auto size = 0u; size <= 100; ++size)
+        {
+            INFO(size);
+            CHECK(find_in(find, 'a', size, size, 0) == size);
+            CHECK(find_in(find, 0xEF, size, size, 0) == size);
+
+            for (auto pos = 0u; pos < size; ++pos)
+            {
+                INFO(pos);
+                CHECK(find_in(find, 'a', size, pos, '7') == pos);
+                CHECK(find_in(find, '/', size, pos, '0') == pos);
+                CHECK(find_in(find, ':', size, pos, '9') == pos);
+                CHECK(find_in(find, 0xEF, size, pos, 0xF0) == pos);
+            }
+        }
+    }
+    SUBCASE("find_not")
+    {
+        auto find_not = [](auto begin, auto end) { return digit_or_high::find_not(begin, end); };
+        for (auto size = 0u; size <= 100; ++size)
+        {
+            INFO(size);
+            CHECK(find_in(find_not, '1', size, size, 0) == size);
+            CHECK(find_in(find_not, 0xFA, size, size, 0) == size);
+
+            for (auto pos = 0u; pos < size; ++pos)
+            {
+                INFO(pos);
+                CHECK(find_in(find_not, '1', size, pos, 'a') == pos);
+                CHECK(find_in(find_not, '9', size, pos, ':') == pos);
+                CHECK(find_in(find_not, '0', size, pos, '/') == pos);
+                CHECK(find_in(find_not, 0xFF, size, pos, 0xEF) == pos);
+            }
+        }
+    }
+}
+
+TEST_CASE("_detail::byte_pair_scanner")
+{
+    using scanner = lexy::_detail::byte_pair_scanner<lexy::_detail::byte_set<'-'>,
+                                                     lexy::_detail::byte_set<'>'>>;
+    auto find     = [](const char* str, std::size_t size) {
+        auto begin = reinterpret_cast<const unsigned char*>(str);
+        return std::size_t(scanner::find(begin, begin + size) - begin);
+    };
+
+    for (auto size = 0u; size <= 100; ++size)
+    {
+        INFO(size);
+        char buffer[128];
+        for (auto i = 0u; i != size; ++i)
+            buffer[i] = i % 2 == 0 ? '-' : 'a';
+        CHECK(find(buffer, size) == (size % 2 == 0 ? size : size - 1));
+
+        for (auto i = 0u; i != size; ++i)
+            buffer[i] = '>';
+        CHECK(find(buffer, size) == size);
+
+        for (auto pos = 0u; pos + 1 < size; ++pos)
+        {
+            INFO(pos);
+            buffer[pos]     = '-';
+            buffer[pos + 1] = '>';
+            CHECK(find(buffer, size) == pos);
+            buffer[pos] = '>';
+        }
+    }
+}
+
+namespace
+{
+template <typename... Bytes>
+std::size_t utf8_length(Bytes... bytes)
+{
+    const unsigned char str[] = {static_cast<unsigned char>(bytes)...};
+    return lexy::_detail::utf8_code_point_length(str, str + sizeof...(Bytes));
+}
+
+// Generates mostly valid UTF-8 with an occasional invalid sequence.
+std::vector<unsigned char> random_utf8(std::mt19937& engine, bool allow_invalid)
+{
+    static const std::vector<unsigned char> valid[] = {
+        {'a'},
+        {'"'},
+        {0x7F},
+        {0xC2, 0x80},
+        {0xC3, 0xA4},
+        {0xDF, 0xBF},
+        {0xE0, 0xA0, 0x80},
+        {0xE2, 0x82, 0xAC},
+        {0xED, 0x9F, 0xBF},
+        {0xEF, 0xBF, 0xBF},
+        {0xF0, 0x90, 0x80, 0x80},
+        {0xF0, 0x9F, 0x98, 0x80},
+        {0xF4, 0x8F, 0xBF, 0xBF},
+    };
+    static const std::vector<unsigned char> invalid[] = {
+        {0x80},       {0xBF},       {0xC0, 0x80}, {0xC1, 0xBF},       {0xC3},
+        {0xE2, 0x82}, {0xE0, 0x9F, 0xBF},         {0xED, 0xA0, 0x80}, {0xF0, 0x8F, 0xBF, 0xBF},
+        {0xF4, 0x90, 0x80, 0x80}, {0xF5, 0x80, 0x80, 0x80},          {0xFF},
+    };
+
+    auto random = [&](int max) { return std::uniform_int_distribution<int>(0, max)(engine); };
+
+    std::vector<unsigned char> result;
+    auto                       size = random(200);
+    for (auto i = 0; i != size; ++i)
+    {
+        if (allow_invalid && random(100) == 0)
+        {
+            auto& seq = invalid[random(int(std::size(invalid)) - 1)];
+            result.insert(result.end(), seq.begin(), seq.end());
+        }
+        else
+        {
+            // Long runs of ASCII are common.
+            auto& seq = random(1) == 0 ? valid[0] : valid[random(int(std::size(valid)) - 1)];
+            result.insert(result.end(), seq.begin(), seq.end());
+        }
+    }
+    return result;
+}
+
+template <typename Stop>
+std::size_t utf8_find_reference(const std::vector<unsigned char>& str)
+{
+    auto begin = str.data();
+    auto end   = begin + str.size();
+
+    auto cur = begin;
+    while (cur != end && !Stop::contains(*cur))
+    {
+        auto length = lexy::_detail::utf8_code_point_length(cur, end);
+        if (length == 0)
+            break;
+        cur += length;
+    }
+    return std::size_t(cur - begin);
+}
+
+template <typename Stop>
+std::size_t utf8_find(const std::vector<unsigned char>& str)
+{
+    auto begin = str.data();
+    return std::size_t(lexy::_detail::utf8_find<Stop>(begin, begin + str.size()) - begin);
+}
+} // namespace
+
+TEST_CASE("_detail::byte_swap_copy")
+{
+    unsigned char src[128];
+    for (auto i = 0u; i != sizeof(src); ++i)
+        src[i] = static_cast<unsigned char>(i);
+
+    for (auto count = 0u; count != 63; ++count)
+    {
+        INFO(count);
+
+        unsigned char dest[128] = {};
+        lexy::_detail::byte_swap_copy<2>(dest, src, count);
+        for (auto i = 0u; i != count * 2; ++i)
+            CHECK(dest[i] == src[i ^ 1]);
+        CHECK(dest[count * 2] == 0);
+    }
+
+    for (auto count = 0u; count != 31; ++count)
+    {
+        INFO(count);
+
+        unsigned char dest[128] = {};
+        lexy::_detail::byte_swap_copy<4>(dest, src, count);
+        for (auto i = 0u; i != count * 4; ++i)
+            CHECK(dest[i] == src[i ^ 3]);
+        CHECK(dest[count * 4] == 0);
+    }
+}
+
+TEST_CASE("_detail::utf8_code_point_length")
+{
+    CHECK(utf8_length('a') == 1);
+    CHECK(utf8_length(0x7F) == 1);
+
+    CHECK(utf8_length(0x80) == 0);
+    CHECK(utf8_length(0xC0, 0x80) == 0);
+    CHECK(utf8_length(0xC1, 0xBF) == 0);
+    CHECK(utf8_length(0xC2, 0x80) == 2);
+    CHECK(utf8_length(0xDF, 0xBF) == 2);
+    CHECK(utf8_length(0xC3) == 0);
+    CHECK(utf8_length(0xC3, 'a') == 0);
+
+    CHECK(utf8_length(0xE0, 0x9F, 0xBF) == 0);
+    CHECK(utf8_length(0xE0, 0xA0, 0x80) == 3);
+    CHECK(utf8_length(0xED, 0x9F, 0xBF) == 3);
+    CHECK(utf8_length(0xED, 0xA0, 0x80) == 0);
+    CHECK(utf8_length(0xEF, 0xBF, 0xBF) == 3);
+    CHECK(utf8_length(0xE2, 0x82) == 0);
+    CHECK(utf8_length(0xE2, 0x82, 0xC0) == 0);
+
+    CHECK(utf8_length(0xF0, 0x8F, 0xBF, 0xBF) == 0);
+    CHECK(utf8_length(0xF0, 0x90, 0x80, 0x80) == 4);
+    CHECK(utf8_length(0xF4, 0x8F, 0xBF, 0xBF) == 4);
+    CHECK(utf8_length(0xF4, 0x90, 0x80, 0x80) == 0);
+    CHECK(utf8_length(0xF5, 0x80, 0x80, 0x80) == 0);
+    CHECK(utf8_length(0xF0, 0x9F, 0x98) == 0);
+    CHECK(utf8_length(0xFF) == 0);
+}
+
+TEST_CASE("_detail::utf8_find")
+{
+    using lexy::_detail::utf8_non_lead;
+    using quote_stop = lexy::_detail::byte_class_union<utf8_non_lead, lexy::_detail::byte_set<'"'>>;
+    using lead_stop  = lexy::_detail::byte_class_union<utf8_non_lead, lexy::_detail::byte_set<0xE2>>;
+
+    std::mt19937 engine(42);
+    for (auto i = 0; i != 2000; ++i)
+    {
+        auto str = random_utf8(engine, i % 2 == 0);
+        INFO(i);
+        CHECK(utf8_find<utf8_non_lead>(str) == utf8_find_reference<utf8_non_lead>(str));
+        CHECK(utf8_find<quote_stop>(str) == utf8_find_reference<quote_stop>(str));
+        CHECK(utf8_find<lead_stop>(str) == utf8_find_reference<lead_stop>(str));
+    }
+}
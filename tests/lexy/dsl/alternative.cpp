@@ -6,6 +6,7 @@
 
 #include "verify.hpp"
 #include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/code_point.hpp>
 
 TEST_CASE("dsl::_trie")
 {
@@ -102,6 +103,69 @@ TEST_CASE("dsl::_alt")
     CHECK(def == 2);
 }
 
+TEST_CASE("dsl::_alt dispatch")
+{
+    // The code point alternative can start with anything, so it needs to be tried in order.
+    static constexpr auto rule
+        = lexy::dsl::_alt<decltype(LEXY_LIT("ab")), lexy::dsl::ascii::_digit,
+                          decltype(LEXY_LIT("12")), lexy::dsl::_cp, decltype(LEXY_LIT("cd"))>{};
+    CHECK(lexy::is_token<decltype(rule)>);
+
+    using engine = decltype(rule)::token_engine;
+    CHECK(engine::_use_dispatch);
+    CHECK(std::is_void_v<engine::_scanner>);
+
+    struct callback
+    {
+        const char* str;
+
+        LEXY_VERIFY_FN int success(const char* cur)
+        {
+            return int(cur - str);
+        }
+
+        LEXY_VERIFY_FN int error(
+            lexy::string_error<lexy::exhausted_alternatives, lexy::ascii_encoding> e)
+        {
+            LEXY_VERIFY_CHECK(e.position() == str);
+            return -1;
+        }
+    };
+
+    // We need an encoding with single byte integer code units to dispatch.
+    auto empty = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "");
+    CHECK(empty == -1);
+
+    auto ab = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "ab");
+    CHECK(ab == 2);
+    auto a = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "a");
+    CHECK(a == 1);
+
+    auto one_two = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "12");
+    CHECK(one_two == 1);
+
+    auto cd = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "cd");
+    CHECK(cd == 1);
+    auto x = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "x");
+    CHECK(x == 1);
+
+    auto invalid = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "\x80");
+    CHECK(invalid == -1);
+}
+
+TEST_CASE("dsl::_alt scanner")
+{
+    using engine = decltype(lexy::dsl::ascii::alpha / LEXY_LIT("12"))::token_engine;
+    using scanner = engine::_scanner;
+    CHECK(!std::is_void_v<scanner>);
+
+    for (auto c = 0; c != 256; ++c)
+    {
+        auto expected = ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '1';
+        CHECK(scanner::contains(static_cast<unsigned char>(c)) == expected);
+    }
+}
+
 TEST_CASE("dsl::operator/")
 {
     // Only check types, behavior is checked above.
@@ -5,8 +5,10 @@
 #include <lexy/dsl/choice.hpp>
 
 #include "verify.hpp"
+#include <lexy/dsl/ascii.hpp>
 #include <lexy/dsl/error.hpp>
 #include <lexy/dsl/label.hpp>
+#include <lexy/dsl/peek.hpp>
 
 TEST_CASE("dsl::operator|")
 {
@@ -148,5 +150,58 @@ TEST_CASE("dsl::operator|")
         auto def = LEXY_VERIFY("def");
         CHECK(def == 1);
     }
+    SUBCASE("dispatch")
+    {
+        static constexpr auto rule
+            = LEXY_LIT("abc") >> lexy::dsl::id<0> | lexy::dsl::peek(lexy::dsl::ascii::digit)
+                  >> lexy::dsl::id<1> | LEXY_LIT("a") >> lexy::dsl::id<2>
+              | lexy::dsl::else_ >> lexy::dsl::id<3>;
+        CHECK(lexy::is_rule<decltype(rule)>);
+
+        using abc_first = lexy::_branch_first_class<decltype(LEXY_LIT("abc") >> lexy::dsl::id<0>)>;
+        CHECK(abc_first::contains('a'));
+        CHECK(!abc_first::contains('b'));
+        using digit_first
+            = lexy::_branch_first_class<decltype(lexy::dsl::peek(lexy::dsl::ascii::digit))>;
+        CHECK(digit_first::contains('0'));
+        CHECK(!digit_first::contains('a'));
+        CHECK(std::is_void_v<lexy::_branch_first_class<decltype(lexy::dsl::else_)>>);
+
+        struct callback
+        {
+            const char* str;
+
+            LEXY_VERIFY_FN int success(const char*, lexy::id<0>)
+            {
+                return 0;
+            }
+            LEXY_VERIFY_FN int success(const char*, lexy::id<1>)
+            {
+                return 1;
+            }
+            LEXY_VERIFY_FN int success(const char*, lexy::id<2>)
+            {
+                return 2;
+            }
+            LEXY_VERIFY_FN int success(const char* cur, lexy::id<3>)
+            {
+                LEXY_VERIFY_CHECK(cur == str);
+                return 3;
+            }
+        };
+
+        // We need an encoding with single byte integer code units to dispatch.
+        auto empty = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "");
+        CHECK(empty == 3);
+
+        auto abc = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "abc");
+        CHECK(abc == 0);
+        auto ab = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "ab");
+        CHECK(ab == 2);
+        auto digit = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "1");
+        CHECK(digit == 1);
+        auto other = LEXY_VERIFY_ENCODING(lexy::ascii_encoding, "x");
+        CHECK(other == 3);
+    }
 }
 
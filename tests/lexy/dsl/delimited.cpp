@@ -6,9 +6,13 @@
 
 #include "verify.hpp"
 #include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/code_point.hpp>
 #include <lexy/dsl/eof.hpp>
 #include <lexy/dsl/list.hpp>
+#include <lexy/dsl/minus.hpp>
 #include <lexy/dsl/option.hpp>
+#include <lexy/parse_tree.hpp>
+#include <string>
 
 namespace
 {
@@ -181,6 +185,173 @@ TEST_CASE("dsl::delimited()")
     }
 }
 
+namespace
+{
+// Not constexpr, so it uses the bulk path.
+struct utf8_callback
+{
+    const LEXY_CHAR8_T* str;
+
+    auto list()
+    {
+        struct b
+        {
+            int count = 0;
+
+            using return_type = int;
+
+            // The sizes add up, so it can receive runs as a single lexeme.
+            using _concatenates_lexemes = std::true_type;
+
+            void operator()(lexy::lexeme_for<lexy::string_input<lexy::utf8_encoding>> lex)
+            {
+                count += int(lex.size());
+            }
+            void operator()(char)
+            {
+                ++count;
+            }
+
+            int finish() &&
+            {
+                return count;
+            }
+        };
+        return b{};
+    }
+    int success(const LEXY_CHAR8_T*, int count)
+    {
+        return count;
+    }
+
+    int error(lexy::string_error<lexy::missing_delimiter, lexy::utf8_encoding>)
+    {
+        return -1;
+    }
+    template <typename Tag>
+    int error(lexy::string_error<Tag, lexy::utf8_encoding> e)
+    {
+        return -int(e.position() - str) - 100;
+    }
+};
+
+// Counts the number of times the sink is invoked.
+template <bool Concatenates>
+struct utf8_sink_calls_callback : utf8_callback
+{
+    auto list()
+    {
+        struct b
+        {
+            int count = 0;
+
+            using return_type = int;
+
+            using _concatenates_lexemes = std::bool_constant<Concatenates>;
+
+            void operator()(lexy::lexeme_for<lexy::string_input<lexy::utf8_encoding>>)
+            {
+                ++count;
+            }
+            void operator()(char)
+            {
+                ++count;
+            }
+
+            int finish() &&
+            {
+                return count;
+            }
+        };
+        return b{};
+    }
+};
+
+struct utf8_quoted
+{
+    static constexpr auto rule
+        = lexy::dsl::quoted(lexy::dsl::code_point - lexy::dsl::ascii::control);
+};
+} // namespace
+
+TEST_CASE("dsl::delimited() on UTF-8")
+{
+    auto parse = [](auto rule, const std::string& str) {
+        auto begin = reinterpret_cast<const LEXY_CHAR8_T*>(str.data());
+        return verify<utf8_callback, lexy::utf8_encoding>(rule, begin, str.size());
+    };
+
+    std::string text;
+    for (auto i = 0; i != 16; ++i)
+        text += "abc \xC3\xA4 \xE2\x82\xAC \xF0\x9F\x98\x80 ";
+    auto error_at = [](const std::string& prefix) { return -int(prefix.size()) - 100; };
+
+    SUBCASE("token")
+    {
+        constexpr auto rule = lexy::dsl::quoted(lexy::dsl::code_point - lexy::dsl::ascii::control);
+
+        CHECK(parse(rule, "\"\"") == 0);
+        CHECK(parse(rule, "\"" + text + "\"") == int(text.size()));
+        CHECK(parse(rule, "\"" + text) == -1);
+        CHECK(parse(rule, "\"" + text + "\n" + text + "\"") == error_at("\"" + text));
+        CHECK(parse(rule, "\"" + text + "\x80" + text + "\"") == error_at("\"" + text));
+        CHECK(parse(rule, "\"" + text + "\xE2\x82" + "\"") == error_at("\"" + text));
+    }
+    SUBCASE("escape")
+    {
+        constexpr auto rule
+            = lexy::dsl::quoted(lexy::dsl::code_point - lexy::dsl::ascii::control,
+                                lexy::dsl::backslash_escape.lit_c<'"'>());
+
+        CHECK(parse(rule, "\"" + text + "\\\"" + text + "\"") == int(2 * text.size() + 1));
+        CHECK(parse(rule, "\"" + text + "\\\"" + text + "\x80\"")
+              == error_at("\"" + text + "\\\"" + text));
+    }
+    SUBCASE("sink granularity")
+    {
+        auto calls = [](auto rule, const std::string& str, auto concatenates) {
+            auto begin = reinterpret_cast<const LEXY_CHAR8_T*>(str.data());
+            return verify<utf8_sink_calls_callback<decltype(concatenates)::value>,
+                          lexy::utf8_encoding>(rule, begin, str.size());
+        };
+        constexpr auto rule
+            = lexy::dsl::quoted(lexy::dsl::code_point - lexy::dsl::ascii::control,
+                                lexy::dsl::backslash_escape.lit_c<'"'>());
+
+        // Every character is forwarded on its own.
+        CHECK(calls(rule, "\"\"", std::false_type{}) == 0);
+        CHECK(calls(rule, "\"" + text + "\"", std::false_type{}) == 16 * 10);
+        CHECK(calls(rule, "\"" + text + "\\\"" + text + "\"", std::false_type{})
+              == 2 * 16 * 10 + 1);
+
+        // Unless the sink only concatenates them, then runs between escape sequences are
+        // forwarded as a single lexeme.
+        CHECK(calls(rule, "\"\"", std::true_type{}) == 0);
+        CHECK(calls(rule, "\"" + text + "\"", std::true_type{}) == 1);
+        CHECK(calls(rule, "\"" + text + "\\\"" + text + "\"", std::true_type{}) == 3);
+
+        CHECK(lexyd::_sink_concatenates_lexemes<decltype(lexy::as_string<std::string>.sink())>);
+        CHECK(lexyd::_sink_concatenates_lexemes<decltype(lexy::noop.sink())>);
+    }
+    SUBCASE("parse tree")
+    {
+        // Tokens are still reported for every character.
+        auto str   = "\"" + text + "\"";
+        auto input = lexy::string_input<lexy::utf8_encoding>(
+            reinterpret_cast<const LEXY_CHAR8_T*>(str.data()), str.size());
+
+        lexy::parse_tree_for<decltype(input)> tree;
+        REQUIRE(lexy::parse_as_tree<utf8_quoted>(tree, input, lexy::noop));
+
+        auto tokens = 0;
+        for (auto [event, node] : tree.traverse())
+            if (event == lexy::traverse_event::leaf)
+                ++tokens;
+        // Quotes plus 10 code points per repetition.
+        CHECK(tokens == 2 + 16 * 10);
+    }
+}
+
 TEST_CASE("predefined dsl::delimited")
 {
     constexpr auto quoted_equivalent = lexy::dsl::delimited(LEXY_LIT("\""));
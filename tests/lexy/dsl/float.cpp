@@ -0,0 +1,197 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/dsl/float.hpp>
+
+#include "verify.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace
+{
+template <typename T>
+T parsed_value;
+
+template <typename T>
+struct float_callback
+{
+    const char* str;
+
+    int success(const char* cur, T value)
+    {
+        parsed_value<T> = value;
+        return int(cur - str);
+    }
+
+    int error(test_error<lexy::expected_char_class> e)
+    {
+        CHECK(e.character_class() == lexy::_detail::string_view("digit.decimal"));
+        return -1;
+    }
+    int error(test_error<lexy::float_overflow> e)
+    {
+        CHECK(e.message() == lexy::_detail::string_view("float overflow"));
+        return -2;
+    }
+};
+
+template <typename T>
+bool same_bits(T lhs, T rhs)
+{
+    return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+
+// Checks that the rule parses the entire string to the same value as the standard library.
+template <typename T>
+bool parses_correctly(const std::string& str)
+{
+    INFO(str);
+
+    T expected;
+    if constexpr (std::is_same_v<T, float>)
+        expected = std::strtof(str.c_str(), nullptr);
+    else
+        expected = std::strtod(str.c_str(), nullptr);
+
+    auto result = verify<float_callback<T>>(lexy::dsl::float_<T>, str.c_str());
+    if (expected > std::numeric_limits<T>::max())
+        return result == -2;
+    else
+        return result == int(str.size()) && same_bits(parsed_value<T>, expected);
+}
+} // namespace
+
+TEST_CASE("dsl::float_")
+{
+    constexpr auto rule = lexy::dsl::float_<double>;
+    CHECK(lexy::is_rule<decltype(rule)>);
+
+    auto parse = [&](const char* str) { return verify<float_callback<double>>(rule, str); };
+
+    SUBCASE("match")
+    {
+        CHECK(parse("") == -1);
+        CHECK(parse("abc") == -1);
+        CHECK(parse(".5") == -1);
+
+        CHECK(parse("1") == 1);
+        CHECK(parsed_value<double> == 1.0);
+        CHECK(parse("123abc") == 3);
+        CHECK(parsed_value<double> == 123.0);
+
+        CHECK(parse("1.5") == 3);
+        CHECK(parsed_value<double> == 1.5);
+        CHECK(parse("1.") == -1);
+        CHECK(parse("1.a") == -1);
+
+        CHECK(parse("15e-1") == 5);
+        CHECK(parsed_value<double> == 1.5);
+        CHECK(parse("0.15E+1") == 7);
+        CHECK(parsed_value<double> == 1.5);
+        CHECK(parse("0.015E2") == 7);
+        CHECK(parsed_value<double> == 1.5);
+        CHECK(parse("1e") == -1);
+        CHECK(parse("1e+") == -1);
+        CHECK(parse("1e-a") == -1);
+    }
+    SUBCASE("overflow")
+    {
+        CHECK(parse("1e309") == -2);
+        CHECK(parse("1797693134862315807937289714053034150799341327710892888e254") == -2);
+        CHECK(parse("1e999999999999999999999999") == -2);
+
+        CHECK(parse("1797693134862315708145274237317043567980705675258449965e254") == 59);
+        CHECK(parsed_value<double> == 1.7976931348623157e308);
+
+        CHECK(verify<float_callback<float>>(lexy::dsl::float_<float>, "1e39") == -2);
+    }
+    SUBCASE("underflow")
+    {
+        CHECK(parse("1e-400") == 6);
+        CHECK(parsed_value<double> == 0.0);
+        CHECK(parse("0e999999999") == 11);
+        CHECK(parsed_value<double> == 0.0);
+        CHECK(parse("1e-999999999999999999999999") == 27);
+        CHECK(parsed_value<double> == 0.0);
+    }
+}
+
+TEST_CASE("lexyd::_float_parser")
+{
+    const char* literals[] = {
+        "0",
+        "0.0",
+        "000000000000000000000000000000000000000.000000000000000000000001",
+        "1",
+        "9007199254740992",
+        "9007199254740993",
+        "9007199254740995",
+        "0.1",
+        "0.3",
+        "3.14159265358979323846264338327950288419716939937510",
+        "123456789012345678901234567890",
+        "1.7976931348623157e308",
+        "2.2250738585072011e-308",
+        "2.2250738585072014e-308",
+        "4.9406564584124654e-324",
+        "2.4703282292062327e-324",
+        "2.4703282292062328e-324",
+        "7.2057594037927933e16",
+        "8.98846567431158e307",
+        "1.00000005960464477550",
+        "7.038531e-26",
+        "3.4028234664e38",
+        "1.17549435e-38",
+        "1.4e-45",
+        "0.00000000000000000000000000000000000000000000000000000000000000001",
+        // Exactly in-between two doubles, followed by many zeroes and then a one.
+        "9007199254740993000000000000000000000000000000000000000000000000000000000000000000000"
+        "00000000000000000000000000000000000000000000000000000000000000000000000000000001e-100",
+    };
+    for (auto literal : literals)
+    {
+        CHECK(parses_correctly<double>(literal));
+        CHECK(parses_correctly<float>(literal));
+    }
+
+    SUBCASE("long literals")
+    {
+        // Halfway between 1 and the next double, with and without a non-zero digit beyond the
+        // maximal number of digits required.
+        auto halfway = std::string("1.00000000000000011102230246251565404236316680908203125");
+        CHECK(parses_correctly<double>(halfway));
+        CHECK(parses_correctly<double>(halfway + std::string(1000, '0')));
+        CHECK(parses_correctly<double>(halfway + std::string(1000, '0') + "1"));
+        CHECK(parses_correctly<double>(std::string(1000, '9') + "e-1000"));
+        CHECK(parses_correctly<double>("0." + std::string(1000, '0') + "1e1100"));
+    }
+    SUBCASE("random")
+    {
+        std::mt19937_64 engine(42);
+        auto            random = [&](int min, int max) {
+            return std::uniform_int_distribution<int>(min, max)(engine);
+        };
+
+        for (auto i = 0; i != 10000; ++i)
+        {
+            std::string literal;
+            auto        digit_count = random(1, 40);
+            auto        dot         = random(0, digit_count);
+            for (auto j = 0; j != digit_count; ++j)
+            {
+                if (j != 0 && j == dot)
+                    literal += '.';
+                literal += static_cast<char>('0' + random(0, 9));
+            }
+            if (random(0, 1) == 1)
+                literal += "e" + std::to_string(random(-360, 330));
+
+            CHECK(parses_correctly<double>(literal));
+            CHECK(parses_correctly<float>(literal));
+        }
+    }
+}
@@ -7,6 +7,7 @@
 #include "verify.hpp"
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 TEST_CASE("lexyd::_digit_count")
@@ -77,6 +78,65 @@ TEST_CASE("lexyd::_digit_count")
     }
 }
 
+TEST_CASE("lexyd::_bounded_integer_parser")
+{
+    // Long inputs are converted eight digits at a time.
+    auto parse = [](auto parser, const char* str, auto& result) {
+        result = 0;
+        return parser.parse(result, str, str + std::strlen(str));
+    };
+
+    SUBCASE("base 10, uint64_t")
+    {
+        using parser = lexy::dsl::_bounded_integer_parser<std::uint64_t, lexy::dsl::decimal, true>;
+        CHECK(lexy::dsl::_can_parse_swar<std::uint64_t, lexy::dsl::decimal, const char*>);
+
+        auto result = std::uint64_t(0);
+        for (auto value : {std::uint64_t(0), std::uint64_t(1), std::uint64_t(12345678),
+                           std::uint64_t(123456789), std::uint64_t(1234567890123456789),
+                           std::uint64_t(9999999999999999999u), UINT64_MAX - 1, UINT64_MAX})
+        {
+            INFO(value);
+            CHECK(parse(parser{}, std::to_string(value).c_str(), result));
+            CHECK(result == value);
+        }
+
+        CHECK(parse(parser{}, "0000000000000000000000000018446744073709551615", result));
+        CHECK(result == UINT64_MAX);
+
+        CHECK(!parse(parser{}, "18446744073709551616", result));
+        CHECK(!parse(parser{}, "20000000000000000000", result));
+        CHECK(!parse(parser{}, "100000000000000000000", result));
+    }
+    SUBCASE("base 10, int32_t")
+    {
+        using parser = lexy::dsl::_bounded_integer_parser<std::int32_t, lexy::dsl::decimal, true>;
+
+        auto result = std::int32_t(0);
+        CHECK(parse(parser{}, "2147483647", result));
+        CHECK(result == INT32_MAX);
+        CHECK(parse(parser{}, "000000002147483647", result));
+        CHECK(result == INT32_MAX);
+
+        CHECK(!parse(parser{}, "2147483648", result));
+        CHECK(!parse(parser{}, "9999999999", result));
+    }
+    SUBCASE("base 16, uint64_t")
+    {
+        using parser = lexy::dsl::_bounded_integer_parser<std::uint64_t, lexy::dsl::hex, true>;
+
+        auto result = std::uint64_t(0);
+        CHECK(parse(parser{}, "123456789abcdef0", result));
+        CHECK(result == 0x123456789ABCDEF0);
+        CHECK(parse(parser{}, "FFFFFFFFffffffff", result));
+        CHECK(result == UINT64_MAX);
+        CHECK(parse(parser{}, "0000000000abc", result));
+        CHECK(result == 0xABC);
+
+        CHECK(!parse(parser{}, "10000000000000000", result));
+    }
+}
+
 TEST_CASE("dsl::integer")
 {
     auto parse = [](auto rule, const char* str) -> int {
@@ -73,6 +73,8 @@ struct test_handler
         return 0;
     }
 
+    static constexpr bool ignores_tokens = true;
+
     template <typename Kind, typename Iterator>
     LEXY_VERIFY_FN void token(Kind, Iterator, Iterator)
     {}
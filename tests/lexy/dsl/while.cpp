@@ -5,6 +5,18 @@
 #include <lexy/dsl/while.hpp>
 
 #include "verify.hpp"
+#include <lexy/dsl/code_point.hpp>
+#include <lexy/dsl/minus.hpp>
+#include <lexy/parse_tree.hpp>
+#include <string>
+
+namespace
+{
+struct utf8_while
+{
+    static constexpr auto rule = lexy::dsl::while_(lexy::dsl::code_point);
+};
+} // namespace
 
 TEST_CASE("dsl::while_()")
 {
@@ -74,6 +86,79 @@ TEST_CASE("dsl::while_()")
     }
 }
 
+TEST_CASE("dsl::while_() on UTF-8")
+{
+    // Not constexpr, so it uses the bulk path.
+    struct callback
+    {
+        const LEXY_CHAR8_T* str;
+
+        int success(const LEXY_CHAR8_T* cur)
+        {
+            return int(cur - str);
+        }
+    };
+
+    auto parse = [](auto rule, const std::string& str) {
+        auto begin = reinterpret_cast<const LEXY_CHAR8_T*>(str.data());
+        return verify<callback, lexy::utf8_encoding>(rule, begin, str.size());
+    };
+
+    SUBCASE("code_point")
+    {
+        constexpr auto rule = while_(lexy::dsl::code_point);
+
+        CHECK(parse(rule, "") == 0);
+        CHECK(parse(rule, "abc") == 3);
+        CHECK(parse(rule, "h\xC3\xA4llo w\xC3\xB6rld") == 13);
+
+        std::string text;
+        for (auto i = 0; i != 16; ++i)
+            text += "abc \xC3\xA4 \xE2\x82\xAC \xF0\x9F\x98\x80 ";
+        CHECK(parse(rule, text) == int(text.size()));
+
+        const char* invalid[] = {"\x80", "\xC0\x80", "\xC3", "\xE0\x9F\xBF", "\xED\xA0\x80",
+                                 "\xF4\x90\x80\x80", "\xFF"};
+        for (auto seq : invalid)
+        {
+            INFO(seq);
+            CHECK(parse(rule, text + seq + text) == int(text.size()));
+            CHECK(parse(rule, "abc" + (seq + text)) == 3);
+        }
+    }
+    SUBCASE("minus")
+    {
+        constexpr auto rule = while_(lexy::dsl::code_point - lexy::dsl::lit_c<'<'>
+                                     - lexy::dsl::lit_c<'&'>);
+
+        std::string text;
+        for (auto i = 0; i != 16; ++i)
+            text += "abc \xC3\xA4 \xE2\x82\xAC \xF0\x9F\x98\x80 ";
+        CHECK(parse(rule, text) == int(text.size()));
+        CHECK(parse(rule, text + "<b>" + text) == int(text.size()));
+        CHECK(parse(rule, text + "&amp;" + text) == int(text.size()));
+        CHECK(parse(rule, text + "\xED\xA0\x80" + text) == int(text.size()));
+    }
+    SUBCASE("parse tree")
+    {
+        // Tokens are still reported for every code point.
+        std::string text;
+        for (auto i = 0; i != 16; ++i)
+            text += "abc \xC3\xA4 \xE2\x82\xAC \xF0\x9F\x98\x80 ";
+        auto input = lexy::string_input<lexy::utf8_encoding>(
+            reinterpret_cast<const LEXY_CHAR8_T*>(text.data()), text.size());
+
+        lexy::parse_tree_for<decltype(input)> tree;
+        REQUIRE(lexy::parse_as_tree<utf8_while>(tree, input, lexy::noop));
+
+        auto tokens = 0;
+        for (auto [event, node] : tree.traverse())
+            if (event == lexy::traverse_event::leaf)
+                ++tokens;
+        CHECK(tokens == 16 * 10);
+    }
+}
+
 TEST_CASE("dsl::while_one()")
 {
     SUBCASE("token")
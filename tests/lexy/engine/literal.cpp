@@ -6,6 +6,8 @@
 
 #include "verify.hpp"
 #include <lexy/_detail/nttp_string.hpp>
+#include <lexy/input/buffer.hpp>
+#include <string>
 
 namespace
 {
@@ -14,6 +16,42 @@ constexpr auto trie_a     = lexy::linear_trie<LEXY_NTTP_STRING("a")>;
 constexpr auto trie_ab    = lexy::linear_trie<LEXY_NTTP_STRING("ab")>;
 constexpr auto trie_abc   = lexy::linear_trie<LEXY_NTTP_STRING("abc")>;
 constexpr auto trie_abc_u = lexy::linear_trie<LEXY_NTTP_STRING(u"abc")>;
+
+constexpr auto trie_5  = lexy::linear_trie<LEXY_NTTP_STRING("abcde")>;
+constexpr auto trie_8  = lexy::linear_trie<LEXY_NTTP_STRING("abcdefgh")>;
+constexpr auto trie_13 = lexy::linear_trie<LEXY_NTTP_STRING("abcdefghijklm")>;
+constexpr auto trie_19 = lexy::linear_trie<LEXY_NTTP_STRING("abcdefghijklmnopqrs")>;
+
+// Checks the literal against all prefixes and all strings with a single mismatch.
+template <const auto& Trie>
+void check_long_literal()
+{
+    using engine = lexy::engine_literal<Trie>;
+
+    std::string literal(Trie._transition, Trie.size());
+    for (auto size = std::size_t(0); size < literal.size(); ++size)
+    {
+        INFO(size);
+        auto prefix = engine_matches<engine>(literal.substr(0, size).c_str());
+        CHECK(!prefix);
+        CHECK(prefix.count == size);
+        CHECK(prefix.ec == engine::index_to_error(size));
+
+        auto mismatch = literal + "abc";
+        mismatch[size] = 'X';
+        auto result    = engine_matches<engine>(mismatch.c_str());
+        CHECK(!result);
+        CHECK(result.count == size);
+        CHECK(result.ec == engine::index_to_error(size));
+    }
+
+    auto exact = engine_matches<engine>(literal.c_str());
+    CHECK(exact);
+    CHECK(exact.count == literal.size());
+    auto longer = engine_matches<engine>((literal + literal).c_str());
+    CHECK(longer);
+    CHECK(longer.count == literal.size());
+}
 } // namespace
 
 TEST_CASE("engine_literal")
@@ -145,5 +183,39 @@ TEST_CASE("engine_literal")
         CHECK(b.count == 0);
         CHECK(b.ec == engine::index_to_error(0));
     }
+    SUBCASE("long")
+    {
+        check_long_literal<trie_5>();
+        check_long_literal<trie_8>();
+        check_long_literal<trie_13>();
+        check_long_literal<trie_19>();
+    }
 }
 
+TEST_CASE("engine_literal sentinel")
+{
+    // Compares the literal a word at a time, even if it extends into the padding.
+    using engine = lexy::engine_literal<trie_13>;
+    auto match   = [](const std::string& str) {
+        auto input  = lexy::buffer<lexy::utf8_encoding>(str.data(), str.size());
+        auto reader = input.reader();
+        CHECK(engine::_compare_words<decltype(reader)>);
+
+        auto ec = engine::match(reader);
+        return std::make_pair(ec, std::size_t(reader.cur() - input.data()));
+    };
+
+    std::string literal(trie_13._transition, trie_13.size());
+    for (auto size = std::size_t(0); size < literal.size(); ++size)
+    {
+        INFO(size);
+        CHECK(match(literal.substr(0, size)) == std::make_pair(engine::index_to_error(size), size));
+
+        auto sentinel  = literal;
+        sentinel[size] = '\xFF';
+        CHECK(match(sentinel) == std::make_pair(engine::index_to_error(size), size));
+    }
+
+    CHECK(match(literal) == std::make_pair(engine::error_code(), literal.size()));
+    CHECK(match(literal + "abc") == std::make_pair(engine::error_code(), literal.size()));
+}
@@ -17,8 +17,95 @@ constexpr auto trie_linear       = lexy::trie<char, LEXY_NTTP_STRING(""), LEXY_N
                                         LEXY_NTTP_STRING("ab"), LEXY_NTTP_STRING("abc")>;
 constexpr auto trie_disjoint
     = lexy::trie<char, LEXY_NTTP_STRING("abc"), LEXY_NTTP_STRING("bcd"), LEXY_NTTP_STRING("cde")>;
+constexpr auto trie_wide
+    = lexy::trie<char, LEXY_NTTP_STRING("a"), LEXY_NTTP_STRING("b"), LEXY_NTTP_STRING("c"),
+                 LEXY_NTTP_STRING("do"), LEXY_NTTP_STRING("double"), LEXY_NTTP_STRING("e"),
+                 LEXY_NTTP_STRING("f"), LEXY_NTTP_STRING("g"), LEXY_NTTP_STRING("if"),
+                 LEXY_NTTP_STRING("int"), LEXY_NTTP_STRING("x0"), LEXY_NTTP_STRING("x1"),
+                 LEXY_NTTP_STRING("x2"), LEXY_NTTP_STRING("x3"), LEXY_NTTP_STRING("x4"),
+                 LEXY_NTTP_STRING("x5"), LEXY_NTTP_STRING("x6"), LEXY_NTTP_STRING("x7"),
+                 LEXY_NTTP_STRING("x8"), LEXY_NTTP_STRING("x9")>;
+
+// The string "kXYZ", where XYZ are the three decimal digits of I.
+template <std::size_t I>
+struct numbered_string
+{
+    static constexpr char str[] = {'k', char('0' + I / 100 % 10), char('0' + I / 10 % 10),
+                                   char('0' + I % 10), '\0'};
+
+    static constexpr auto get()
+    {
+        return lexy::_detail::basic_string_view<char>(str, 4);
+    }
+};
+
+template <std::size_t... I>
+constexpr auto make_trie_numbered(lexy::_detail::index_sequence<I...>)
+{
+    return lexy::trie<char, numbered_string<I>...>;
+}
+constexpr auto trie_numbered = make_trie_numbered(lexy::_detail::make_index_sequence<1000>{});
 } // namespace
 
+TEST_CASE("trie")
+{
+    SUBCASE("basic")
+    {
+        // Nodes are numbered in insertion order, transitions are sorted by their target.
+        CHECK(trie_basic.transition_count(0) == 2);
+        CHECK(trie_basic.transition_char(0, 0) == 'a');
+        CHECK(trie_basic.transition_next(0, 0) == 1);
+        CHECK(trie_basic.transition_char(0, 1) == 'b');
+        CHECK(trie_basic.transition_next(0, 1) == 5);
+        CHECK(!trie_basic.node_accept(0));
+
+        CHECK(trie_basic.transition_count(1) == 2);
+        CHECK(trie_basic.transition_char(1, 0) == 'b');
+        CHECK(trie_basic.transition_next(1, 0) == 2);
+        CHECK(trie_basic.transition_char(1, 1) == 'c');
+        CHECK(trie_basic.transition_next(1, 1) == 4);
+        CHECK(!trie_basic.node_accept(1));
+
+        CHECK(trie_basic.transition_count(2) == 1);
+        CHECK(trie_basic.transition_next(2, 0) == 3);
+        CHECK(trie_basic.node_accept(2));
+        CHECK(trie_basic.transition_count(3) == 0);
+        CHECK(trie_basic.node_accept(3));
+        CHECK(trie_basic.transition_count(4) == 0);
+        CHECK(trie_basic.node_accept(4));
+
+        CHECK(trie_basic.transition_count(5) == 1);
+        CHECK(trie_basic.transition_next(5, 0) == 6);
+        CHECK(trie_basic.transition_count(6) == 1);
+        CHECK(trie_basic.transition_next(6, 0) == 7);
+        CHECK(trie_basic.transition_count(7) == 0);
+        CHECK(trie_basic.node_accept(7));
+    }
+    SUBCASE("many strings")
+    {
+        // k -> 10 hundreds -> 10 tens each -> 10 ones each.
+        CHECK(sizeof(trie_numbered._node_accept) == 1 + 1 + 10 + 100 + 1000);
+
+        CHECK(trie_numbered.transition_count(0) == 1);
+        auto k = trie_numbered.transition_next(0, 0);
+        CHECK(trie_numbered.transition_count(k) == 10);
+
+        auto node = k;
+        for (auto c : {'4', '2', '7'})
+        {
+            auto next = node;
+            for (auto t = 0u; t != trie_numbered.transition_count(node); ++t)
+                if (trie_numbered.transition_char(node, t) == c)
+                    next = trie_numbered.transition_next(node, t);
+            CHECK(next != node);
+            CHECK(!trie_numbered.node_accept(node));
+            node = next;
+        }
+        CHECK(trie_numbered.node_accept(node));
+        CHECK(trie_numbered.transition_count(node) == 0);
+    }
+}
+
 TEST_CASE("engine_trie")
 {
     SUBCASE("empty trie")
@@ -133,3 +220,85 @@ TEST_CASE("engine_trie")
     }
 }
 
+
+TEST_CASE("engine_trie lookup table")
+{
+    using engine = lexy::engine_trie<trie_wide>;
+    CHECK(lexy::engine_is_matcher<engine>);
+    CHECK(engine::_scanner::contains('x'));
+    CHECK(!engine::_scanner::contains('h'));
+    CHECK(std::is_void_v<lexy::engine_trie<trie_linear>::_scanner>);
+
+    constexpr auto constexpr_match = [] {
+        auto input  = lexy::zstring_input("x7");
+        auto reader = input.reader();
+        return engine::match(reader);
+    }();
+    CHECK(constexpr_match == engine::error_code());
+
+    auto empty = engine_matches<engine>("");
+    CHECK(!empty);
+    CHECK(empty.count == 0);
+
+    auto a = engine_matches<engine>("a");
+    CHECK(a);
+    CHECK(a.count == 1);
+    auto g = engine_matches<engine>("gg");
+    CHECK(g);
+    CHECK(g.count == 1);
+    auto h = engine_matches<engine>("h");
+    CHECK(!h);
+    CHECK(h.count == 0);
+
+    auto d = engine_matches<engine>("d");
+    CHECK(!d);
+    CHECK(d.count == 1);
+    auto do_ = engine_matches<engine>("dou");
+    CHECK(do_);
+    CHECK(do_.count == 2);
+    auto double_ = engine_matches<engine>("double");
+    CHECK(double_);
+    CHECK(double_.count == 6);
+
+    auto in = engine_matches<engine>("in");
+    CHECK(!in);
+    CHECK(in.count == 2);
+    auto int_ = engine_matches<engine>("int");
+    CHECK(int_);
+    CHECK(int_.count == 3);
+
+    for (auto c = '0'; c <= '9'; ++c)
+    {
+        const char str[] = {'x', c, c, '\0'};
+        INFO(str);
+
+        auto result = engine_matches<engine>(str);
+        CHECK(result);
+        CHECK(result.count == 2);
+    }
+    auto x = engine_matches<engine>("xa");
+    CHECK(!x);
+    CHECK(x.count == 1);
+
+    auto non_ascii = engine_matches<engine>("\xFF");
+    CHECK(!non_ascii);
+    CHECK(non_ascii.count == 0);
+}
+
+TEST_CASE("engine_trie lookup table and linear search agree")
+{
+    using table  = lexy::engine_trie<trie_wide, 1>;
+    using linear = lexy::engine_trie<trie_wide, std::size_t(-1)>;
+
+    const char* strings[] = {"",   "a",  "gg", "h",   "d",  "dou", "double", "in",
+                             "int", "x0", "x9", "xa", "xx", "if",  "\xFF"};
+    for (auto str : strings)
+    {
+        INFO(str);
+
+        auto table_result  = engine_matches<table>(str);
+        auto linear_result = engine_matches<linear>(str);
+        CHECK(bool(table_result) == bool(linear_result));
+        CHECK(table_result.count == linear_result.count);
+    }
+}
@@ -6,12 +6,23 @@
 
 #include "verify.hpp"
 #include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/char_class.hpp>
 #include <lexy/engine/literal.hpp>
+#include <lexy/input/buffer.hpp>
+#include <string>
 
 namespace
 {
-constexpr auto trie_ab = lexy::linear_trie<LEXY_NTTP_STRING("ab")>;
-}
+constexpr auto trie_ab  = lexy::linear_trie<LEXY_NTTP_STRING("ab")>;
+constexpr auto strie_ab = lexy::shallow_trie<LEXY_NTTP_STRING("ab")>;
+
+// Long enough to use the vectorized code path.
+constexpr auto long_str
+    = "a+a+aa-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+"
+      "-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+"
+      "-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+a";
+constexpr auto long_size = std::char_traits<char>::length(long_str);
+} // namespace
 
 TEST_CASE("engine_until")
 {
@@ -50,6 +61,101 @@ TEST_CASE("engine_until")
     CHECK(!unterminated);
     CHECK(unterminated.count == 2);
     CHECK(unterminated.ec == condition::index_to_error(0));
+
+    auto long_unterminated = engine_matches<engine>(long_str);
+    CHECK(!long_unterminated);
+    CHECK(long_unterminated.count == long_size);
+    CHECK(long_unterminated.ec == condition::index_to_error(0));
+
+    std::string long_terminated = long_str;
+    long_terminated += "ab";
+    auto long_ = engine_matches<engine>(long_terminated.c_str());
+    CHECK(long_);
+    CHECK(long_.count == long_size + 2);
+}
+
+TEST_CASE("engine_until char set")
+{
+    using condition = lexy::engine_char_set<strie_ab>;
+    using engine    = lexy::engine_until<condition>;
+
+    auto empty = engine_matches<engine>("");
+    CHECK(!empty);
+    CHECK(empty.count == 0);
+
+    auto zero = engine_matches<engine>("b");
+    CHECK(zero);
+    CHECK(zero.count == 1);
+    auto three = engine_matches<engine>("+-+a");
+    CHECK(three);
+    CHECK(three.count == 4);
+
+    auto long_ = engine_matches<engine>(long_str);
+    CHECK(long_);
+    CHECK(long_.count == 1);
+    auto long_unterminated = engine_matches<engine>(long_str + 6);
+    CHECK(long_unterminated);
+    CHECK(long_unterminated.count == long_size - 6);
+
+    auto unterminated = engine_matches<engine>("-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+");
+    CHECK(!unterminated);
+    CHECK(unterminated.count == 40);
+}
+
+TEST_CASE("engine_until padded")
+{
+    // The padding consists of zeros, so the condition only matches there.
+    using engine = lexy::engine_until<lexy::engine_char_range<'\0', '\0'>>;
+
+    for (auto size = 0u; size != 100; ++size)
+    {
+        INFO(size);
+        std::string str(size, '-');
+
+        auto input  = lexy::padded_buffer<>(str.data(), str.size());
+        auto reader = input.reader();
+
+        CHECK(engine::match(reader) != engine::error_code());
+        CHECK(reader.cur() == input.end());
+    }
+}
+
+TEST_CASE("engine_until sentinel")
+{
+    // The input ends at the first sentinel, even if the condition matches after it.
+    using engine = lexy::engine_until<lexy::engine_literal<trie_ab>>;
+
+    auto match = [](const auto& input) {
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_sentinel_byte_reader<decltype(reader)>);
+
+        CHECK(engine::match(reader) != engine::error_code());
+        return std::size_t(reader.cur() - input.data());
+    };
+
+    for (auto size = 0u; size != 100; ++size)
+    {
+        INFO(size);
+        auto str = std::string(size, '-') + "\xFF-ab";
+
+        CHECK(match(lexy::buffer<lexy::ascii_encoding>(str.data(), str.size())) == size);
+        CHECK(match(lexy::padded_buffer<lexy::ascii_encoding>(str.data(), str.size())) == size);
+
+        // The first character of the condition right before the sentinel is not a match.
+        str = std::string(size, '-') + "a\xFF" "b";
+        CHECK(match(lexy::buffer<lexy::ascii_encoding>(str.data(), str.size())) == size + 1);
+    }
+
+    for (auto size = 0u; size != 100; ++size)
+    {
+        INFO(size);
+        auto str = std::string(size, '-') + "a-ab-";
+
+        auto input  = lexy::buffer<lexy::ascii_encoding>(str.data(), str.size());
+        auto reader = input.reader();
+        CHECK(engine::match(reader) == engine::error_code());
+        CHECK(reader.cur() == input.data() + size + 4);
+    }
 }
 
 TEST_CASE("engine_until_eof")
@@ -82,5 +188,9 @@ TEST_CASE("engine_until_eof")
     auto partial_end = engine_matches<engine>("+a+a");
     CHECK(partial_end);
     CHECK(partial_end.count == 4);
+
+    auto long_ = engine_matches<engine>(long_str);
+    CHECK(long_);
+    CHECK(long_.count == long_size);
 }
 
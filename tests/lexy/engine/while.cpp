@@ -5,8 +5,13 @@
 #include <lexy/engine/while.hpp>
 
 #include "verify.hpp"
+#include <lexy/_detail/ascii_table.hpp>
 #include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/char_class.hpp>
+#include <lexy/engine/code_point.hpp>
 #include <lexy/engine/literal.hpp>
+#include <lexy/input/buffer.hpp>
+#include <string>
 
 namespace
 {
@@ -38,3 +43,122 @@ TEST_CASE("engine_while")
     CHECK(partial.count == 2);
 }
 
+
+namespace
+{
+static constexpr auto strie = lexy::shallow_trie<LEXY_NTTP_STRING(" \t")>;
+
+// Matches a long run of member, followed by c, against engine_while.
+template <typename Matcher>
+bool matches_run(char member, char c)
+{
+    std::string str(100, member);
+    str += c;
+    str += member;
+
+    auto result = engine_matches<lexy::engine_while<Matcher>>(str.c_str());
+
+    auto single = engine_matches<Matcher>(str.c_str() + 100);
+    return result.count == (single ? 102 : 100);
+}
+} // namespace
+
+TEST_CASE("engine_while char class")
+{
+    SUBCASE("engine_char_range")
+    {
+        using matcher = lexy::engine_char_range<'0', '9'>;
+        using engine  = lexy::engine_while<matcher>;
+
+        auto empty = engine_matches<engine>("");
+        CHECK(empty);
+        CHECK(empty.count == 0);
+
+        auto digits = engine_matches<engine>("0123456789012345678901234567890123456789abc");
+        CHECK(digits);
+        CHECK(digits.count == 40);
+
+        for (auto c = 1; c < 256; ++c)
+        {
+            INFO(c);
+            CHECK(matches_run<matcher>('5', char(c)));
+        }
+    }
+    SUBCASE("engine_char_set")
+    {
+        using matcher = lexy::engine_char_set<strie>;
+        using engine  = lexy::engine_while<matcher>;
+
+        auto blank = engine_matches<engine>("  \t  \t  \t  \t  \t  \t  \t  \t  \t  \tabc");
+        CHECK(blank);
+        CHECK(blank.count == 30);
+
+        for (auto c = 1; c < 256; ++c)
+        {
+            INFO(c);
+            CHECK(matches_run<matcher>(' ', char(c)));
+        }
+    }
+    SUBCASE("engine_ascii_table")
+    {
+        using matcher = lexy::engine_ascii_table<lexy::_detail::dsl_ascii_table,
+                                                 lexy::_detail::ascii_table_space>;
+        using engine  = lexy::engine_while<matcher>;
+
+        auto space = engine_matches<engine>(" \n\r\t\f\v \n\r\t\f\v \n\r\t\f\v \n\r\t\f\v abc");
+        CHECK(space);
+        CHECK(space.count == 25);
+
+        for (auto c = 1; c < 256; ++c)
+        {
+            INFO(c);
+            CHECK(matches_run<matcher>('\t', char(c)));
+        }
+    }
+}
+
+TEST_CASE("engine_while padded")
+{
+    // The padding consists of zeros, which are part of the range.
+    using engine = lexy::engine_while<lexy::engine_char_range<'\0', '9'>>;
+
+    for (auto size = 0u; size != 100; ++size)
+    {
+        INFO(size);
+        std::string str(size, '5');
+
+        auto input  = lexy::padded_buffer<>(str.data(), str.size());
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_padded_reader<decltype(reader)>);
+
+        CHECK(engine::match(reader) == engine::error_code());
+        CHECK(reader.cur() == input.end());
+    }
+}
+
+TEST_CASE("engine_while sentinel")
+{
+    // The input ends at the first sentinel, even if there is more input after it.
+    using engine = lexy::engine_while<lexy::engine_cp_auto>;
+
+    auto match = [](const auto& input) {
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_sentinel_byte_reader<decltype(reader)>);
+
+        CHECK(engine::match(reader) == engine::error_code());
+        return std::size_t(reader.cur() - input.data());
+    };
+
+    for (auto size = 0u; size != 100; ++size)
+    {
+        INFO(size);
+        std::string str;
+        while (str.size() < size)
+            str += "a\xC3\xA4";
+        auto end = str.size();
+        str += "\xFF" "abc";
+
+        CHECK(match(lexy::buffer<lexy::utf8_encoding>(str.data(), str.size())) == end);
+        CHECK(match(lexy::padded_buffer<lexy::utf8_encoding>(str.data(), str.size())) == end);
+    }
+}
@@ -5,6 +5,8 @@
 #include <lexy/input/buffer.hpp>
 
 #include <doctest/doctest.h>
+#include <string>
+#include <vector>
 
 #if defined(__has_include) && __has_include(<memory_resource>)
 #    include <memory_resource>
@@ -165,6 +167,55 @@ TEST_CASE("buffer")
     }
 #endif
 
+    SUBCASE("adopt")
+    {
+        using buffer_t = lexy::buffer<>;
+
+        auto memory = static_cast<char*>(
+            lexy::_detail::default_memory_resource{}.allocate(buffer_t::allocation_size(3),
+                                                              buffer_t::allocation_alignment()));
+        std::memcpy(memory, str, 3);
+
+        auto buffer = buffer_t::adopt(memory, 3);
+        CHECK(buffer.data() == memory);
+        verify(buffer);
+        CHECK(memory[3] == '\0');
+    }
+    SUBCASE("adopt, custom resource")
+    {
+        struct resource_t
+        {
+            int deallocations = 0;
+
+            void* allocate(std::size_t bytes, std::size_t)
+            {
+                return ::operator new(bytes);
+            }
+            void deallocate(void* ptr, std::size_t, std::size_t) noexcept
+            {
+                ++deallocations;
+                ::operator delete(ptr);
+            }
+
+            bool operator==(const resource_t& other) const noexcept
+            {
+                return this == &other;
+            }
+        } resource;
+
+        using buffer_t = lexy::buffer<lexy::ascii_encoding, resource_t>;
+        {
+            auto memory = static_cast<char*>(resource.allocate(buffer_t::allocation_size(3),
+                                                               buffer_t::allocation_alignment()));
+            std::memcpy(memory, str, 3);
+
+            auto buffer = buffer_t::adopt(memory, 3, &resource);
+            verify(buffer);
+            CHECK(memory[3] == lexy::ascii_encoding::eof());
+        }
+        CHECK(resource.deallocations == 1);
+    }
+
     SUBCASE("copy constructor")
     {
         const lexy::buffer original(str, str + 3);
@@ -228,6 +279,30 @@ TEST_CASE("buffer")
         CHECK(reader.peek() == lexy::default_encoding::eof());
         CHECK(reader.eof());
     }
+    SUBCASE("reader, terminator")
+    {
+        static const char zeros[] = {'a', '\0', '\0'};
+        const lexy::buffer buffer(zeros, 3);
+
+        auto reader = buffer.reader();
+        CHECK(reader.peek() == 'a');
+        CHECK(!reader.eof());
+
+        reader.bump();
+        CHECK(reader.cur() == buffer.data() + 1);
+        CHECK(reader.peek() == 0);
+        CHECK(!reader.eof());
+
+        reader.bump();
+        CHECK(reader.cur() == buffer.data() + 2);
+        CHECK(reader.peek() == 0);
+        CHECK(!reader.eof());
+
+        reader.bump();
+        CHECK(reader.cur() == buffer.data() + 3);
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.eof());
+    }
     SUBCASE("reader, sentinel")
     {
         const lexy::buffer<lexy::ascii_encoding> buffer(str, 3);
@@ -252,6 +327,46 @@ TEST_CASE("buffer")
         CHECK(reader.peek() == lexy::default_encoding::eof());
         CHECK(reader.eof());
     }
+    SUBCASE("padded")
+    {
+        const lexy::padded_buffer<> buffer(str, 3);
+        verify(buffer);
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % lexy::_detail::input_padding == 0);
+
+        auto reader = buffer.reader();
+        CHECK(lexy::_detail::is_padded_reader<decltype(reader)>);
+        CHECK(!lexy::_detail::is_padded_reader<decltype(lexy::buffer(str, 3).reader())>);
+        // Buffers with a sentinel are always padded.
+        CHECK(lexy::_detail::is_padded_reader<
+              decltype(lexy::buffer<lexy::ascii_encoding>(str, 3).reader())>);
+        CHECK(std::is_same_v<decltype(lexy::lexeme(reader, buffer.end())),
+                             lexy::padded_buffer_lexeme<>>);
+        CHECK(std::is_same_v<lexy::padded_buffer_error<lexy::expected_char_class>,
+                             lexy::error<decltype(reader), lexy::expected_char_class>>);
+
+        reader.bump();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.cur() == buffer.data() + 3);
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.eof());
+    }
+    SUBCASE("padded, sentinel")
+    {
+        const lexy::padded_buffer<lexy::ascii_encoding> buffer(str, 3);
+        verify(buffer);
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % lexy::_detail::input_padding == 0);
+
+        auto reader = buffer.reader();
+        CHECK(lexy::_detail::is_padded_reader<decltype(reader)>);
+
+        reader.bump();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.cur() == buffer.data() + 3);
+        CHECK(reader.peek() == lexy::ascii_encoding::eof());
+        CHECK(reader.eof());
+    }
 }
 
 TEST_CASE("make_buffer")
@@ -437,3 +552,76 @@ TEST_CASE("make_buffer")
     }
 }
 
+
+TEST_CASE("make_buffer_as")
+{
+    constexpr auto make = lexy::make_buffer_as<lexy::utf8_encoding>;
+    // "a\u00E4\u20AC\U0001F600", repeated to use the vectorized code.
+    const std::string expected = [] {
+        std::string result(40, 'a');
+        return result + "a\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80" + result;
+    }();
+    const std::u32string code_points = [] {
+        std::u32string result(40, U'a');
+        return result + U"a\u00E4\u20AC\U0001F600" + result;
+    }();
+
+    auto check = [&](const auto& buffer, const std::string& str) {
+        CHECK(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()) == str);
+    };
+
+    // Encodes the code points with the BOM in the specified format.
+    auto encode = [&](std::size_t size, bool big) {
+        std::vector<unsigned char> result;
+        auto                       append = [&](std::uint_least32_t unit) {
+            for (auto i = 0u; i != size; ++i)
+            {
+                auto shift = 8 * (big ? size - 1 - i : i);
+                result.push_back(static_cast<unsigned char>(unit >> shift));
+            }
+        };
+
+        append(0xFEFF);
+        for (auto cp : code_points)
+        {
+            if (size == 2 && cp > 0xFFFF)
+            {
+                append(0xD800 + ((cp - 0x10000) >> 10));
+                append(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            }
+            else
+                append(cp);
+        }
+        return result;
+    };
+
+    SUBCASE("utf8")
+    {
+        check(make(expected.data(), expected.size()), expected);
+        check(make(("\xEF\xBB\xBF" + expected).data(), expected.size() + 3), expected);
+        check(make("", 0), "");
+    }
+    SUBCASE("utf16")
+    {
+        auto little = encode(2, false);
+        check(make(little.data(), little.size()), expected);
+
+        auto big = encode(2, true);
+        check(make(big.data(), big.size()), expected);
+
+        const unsigned char invalid[] = {0xFE, 0xFF, 0xD8, 0x00, 0x00, 0x61, 0xDC, 0x00, 0x00};
+        check(make(invalid, sizeof(invalid)), "\xEF\xBF\xBD" "a" "\xEF\xBF\xBD" "\xEF\xBF\xBD");
+    }
+    SUBCASE("utf32")
+    {
+        auto little = encode(4, false);
+        check(make(little.data(), little.size()), expected);
+
+        auto big = encode(4, true);
+        check(make(big.data(), big.size()), expected);
+
+        const unsigned char invalid[]
+            = {0x00, 0x00, 0xFE, 0xFF, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x61};
+        check(make(invalid, sizeof(invalid)), "\xEF\xBF\xBD" "a");
+    }
+}
@@ -4,8 +4,11 @@
 
 #include <lexy/input/file.hpp>
 
+#include <atomic>
 #include <cstdio>
 #include <doctest/doctest.h>
+#include <new>
+#include <string>
 
 #if defined(__has_include) && __has_include(<memory_resource>)
 #    include <memory_resource>
@@ -18,6 +21,39 @@ namespace
 {
 constexpr auto test_file_name = "lexy-input-file.test.delete-me";
 
+// A memory resource that isn't thread-safe and fails after a number of allocations.
+class fragile_resource
+{
+public:
+    explicit fragile_resource(std::size_t max_allocations) : _max_allocations(max_allocations) {}
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        CHECK(!_in_use.exchange(true));
+        auto count = ++_allocations;
+        _in_use    = false;
+
+        if (count > _max_allocations)
+            throw std::bad_alloc();
+        return lexy::_detail::default_memory_resource{}.allocate(bytes, alignment);
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        lexy::_detail::default_memory_resource{}.deallocate(ptr, bytes, alignment);
+    }
+
+    friend bool operator==(const fragile_resource& lhs, const fragile_resource& rhs) noexcept
+    {
+        return &lhs == &rhs;
+    }
+
+private:
+    std::atomic<bool> _in_use{false};
+    std::size_t       _allocations = 0;
+    std::size_t       _max_allocations;
+};
+
 void write_test_data(const char* data)
 {
     auto file = std::fopen(test_file_name, "wb");
@@ -216,3 +252,199 @@ TEST_CASE("read_file")
     std::remove(test_file_name);
 }
 
+
+TEST_CASE("read_file_as")
+{
+    std::remove(test_file_name);
+
+    SUBCASE("non-existing file")
+    {
+        auto buffer = lexy::read_file_as<lexy::utf8_encoding>(test_file_name);
+        CHECK(!buffer);
+        CHECK(buffer.error() == lexy::file_error::file_not_found);
+    }
+    SUBCASE("utf8")
+    {
+        write_test_data("\xEF\xBB\xBF" "abc");
+
+        auto buffer = lexy::read_file_as<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(buffer);
+        CHECK(buffer.value().size() == 3);
+        CHECK(buffer.value().data()[0] == 'a');
+    }
+    SUBCASE("utf16")
+    {
+        {
+            const unsigned char data[] = {0xFE, 0xFF, 0x00, 0x61, 0x00, 0xE4};
+            auto                file   = std::fopen(test_file_name, "wb");
+            std::fwrite(data, 1, sizeof(data), file);
+            std::fclose(file);
+        }
+
+        auto buffer = lexy::read_file_as<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(buffer);
+        CHECK(buffer.value().size() == 3);
+        CHECK(buffer.value().data()[0] == 'a');
+        CHECK(buffer.value().data()[1] == 0xC3);
+        CHECK(buffer.value().data()[2] == 0xA4);
+    }
+
+    std::remove(test_file_name);
+}
+
+TEST_CASE("read_files")
+{
+    // Files with the contents 0, 1, 2, ..., every third one missing.
+    constexpr auto count = std::size_t(50);
+    std::string    names[count];
+    const char*    paths[count];
+    for (auto i = std::size_t(0); i != count; ++i)
+    {
+        names[i] = test_file_name + std::to_string(i);
+        paths[i] = names[i].c_str();
+
+        std::remove(paths[i]);
+        if (i % 3 != 0)
+        {
+            auto file = std::fopen(paths[i], "wb");
+            std::fputs(std::to_string(i).c_str(), file);
+            std::fclose(file);
+        }
+    }
+
+    auto verify = [&](const auto& batch) {
+        REQUIRE(batch.size() == count);
+        for (auto i = std::size_t(0); i != count; ++i)
+        {
+            INFO(i);
+            if (i % 3 == 0)
+            {
+                REQUIRE(!batch[i]);
+                CHECK(batch[i].error() == lexy::file_error::file_not_found);
+            }
+            else
+            {
+                REQUIRE(batch[i]);
+                auto& buffer = batch[i].value();
+                CHECK(std::string(buffer.data(), buffer.size()) == std::to_string(i));
+            }
+        }
+    };
+
+    SUBCASE("single thread")
+    {
+        verify(lexy::read_files(paths, count, 1));
+    }
+    SUBCASE("multiple threads")
+    {
+        verify(lexy::read_files(paths, count, 4));
+    }
+    SUBCASE("no files")
+    {
+        CHECK(lexy::read_files(paths, 0).size() == 0);
+    }
+#if LEXY_HAS_RESOURCE
+    SUBCASE("arena")
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        verify(lexy::read_files(paths, count, 4, &arena));
+    }
+#endif
+    SUBCASE("serialized resource")
+    {
+        fragile_resource resource(count + 1);
+        verify(lexy::read_files(paths, count, 4, &resource));
+    }
+    SUBCASE("throwing resource")
+    {
+        // The first allocation is for the results, the others for the buffers.
+        fragile_resource resource(10);
+        CHECK_THROWS_AS(lexy::read_files(paths, count, 4, &resource), std::bad_alloc);
+    }
+
+    for (auto path : paths)
+        std::remove(path);
+}
+
+TEST_CASE("map_file")
+{
+    std::remove(test_file_name);
+
+    SUBCASE("non-existing file")
+    {
+        auto file = lexy::map_file(test_file_name);
+        CHECK(!file);
+        CHECK(file.error() == lexy::file_error::file_not_found);
+    }
+    SUBCASE("empty file")
+    {
+        write_test_data("");
+
+        auto file = lexy::map_file(test_file_name);
+        REQUIRE(file);
+        CHECK(file.value().size() == 0);
+
+        auto reader = file.value().reader();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.eof());
+    }
+    SUBCASE("tiny file")
+    {
+        write_test_data("abc");
+
+        auto file = lexy::map_file<lexy::ascii_encoding>(test_file_name);
+        REQUIRE(file);
+        CHECK(file.value().size() == 3);
+
+        auto reader = file.value().reader();
+        CHECK(reader.peek() == 'a');
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+        reader.bump();
+        CHECK(reader.peek() == lexy::ascii_encoding::eof());
+        CHECK(reader.eof());
+    }
+    SUBCASE("big file")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 200 * 1024; ++i)
+                std::fputc('a', file);
+            for (auto i = 0; i != 200 * 1024; ++i)
+                std::fputc('b', file);
+            std::fclose(file);
+        }
+
+        auto result = lexy::map_file(test_file_name, lexy::file_advice::will_need);
+        REQUIRE(result);
+
+        // Moving doesn't affect the mapping.
+        auto file = std::move(result).value();
+        file.advise(lexy::file_advice::random);
+        file.advise(lexy::file_advice::normal);
+        CHECK(file.size() == 400 * 1024);
+
+        auto reader = file.reader();
+        for (auto i = 0; i != 200 * 1024; ++i)
+        {
+            CHECK(reader.peek() == 'a');
+            reader.bump();
+        }
+        for (auto i = 0; i != 200 * 1024; ++i)
+        {
+            CHECK(reader.peek() == 'b');
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.eof());
+
+        lexy::mapped_file<> other;
+        other = std::move(file);
+        CHECK(other.size() == 400 * 1024);
+        CHECK(file.size() == 0);
+    }
+
+    std::remove(test_file_name);
+}
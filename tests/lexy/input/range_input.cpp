@@ -5,6 +5,8 @@
 #include <lexy/input/range_input.hpp>
 
 #include <doctest/doctest.h>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -65,3 +67,66 @@ TEST_CASE("range_input")
     CHECK(reader.eof());
 }
 
+TEST_CASE("range_input contiguous")
+{
+    SUBCASE("std::string")
+    {
+        std::string str = "abc";
+
+        auto input = lexy::range_input(str.begin(), str.end());
+        CHECK(std::is_same_v<decltype(input)::iterator, std::string::iterator>);
+        CHECK(input.begin() == str.begin());
+        CHECK(input.end() == str.end());
+
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_contiguous_byte_reader<decltype(reader)>);
+        CHECK(std::is_same_v<decltype(reader.cur()), std::string::iterator>);
+        CHECK(reader.cur() == str.begin());
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+        CHECK(reader.cur() == str.begin() + 1);
+
+        reader.bump();
+        reader.bump();
+        CHECK(reader.eof());
+        CHECK(reader.cur() == str.end());
+    }
+    SUBCASE("std::vector")
+    {
+        const std::vector<char> vec = {'a', 'b', 'c'};
+
+        auto input  = lexy::range_input(vec.begin(), vec.end());
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_contiguous_byte_reader<decltype(reader)>);
+        CHECK(reader.cur() == vec.begin());
+        CHECK(reader.peek() == 'a');
+    }
+    SUBCASE("pointer")
+    {
+        const char str[] = "abc";
+
+        auto input  = lexy::range_input(str, str + 3);
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_contiguous_byte_reader<decltype(reader)>);
+        CHECK(reader.cur() == str);
+    }
+    SUBCASE("mismatched character type")
+    {
+        std::string str = "abc";
+
+        auto input = lexy::range_input<lexy::utf8_encoding, std::string::iterator>(str.begin(),
+                                                                                    str.end());
+        auto reader = input.reader();
+        CHECK(!lexy::_detail::is_contiguous_byte_reader<decltype(reader)>);
+        CHECK(reader.peek() == 'a');
+        CHECK(reader.cur() == str.begin());
+    }
+    SUBCASE("empty")
+    {
+        lexy::range_input<lexy::default_encoding, std::string::iterator> input;
+        CHECK(input.begin() == input.end());
+        CHECK(input.reader().eof());
+    }
+}
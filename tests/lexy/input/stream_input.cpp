@@ -0,0 +1,169 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/input/stream_input.hpp>
+
+#include <algorithm>
+#include <doctest/doctest.h>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/eof.hpp>
+#include <lexy/dsl/list.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/newline.hpp>
+#include <lexy/dsl/while.hpp>
+#include <lexy/match.hpp>
+#include <string>
+
+namespace
+{
+// Reads at most three characters at a time from a string.
+class test_source
+{
+public:
+    using encoding = lexy::default_encoding;
+
+    explicit test_source(std::string str) : _str(LEXY_MOV(str)), _pos(0) {}
+
+    std::size_t read(char* buffer, std::size_t size)
+    {
+        auto count = std::min({size, std::size_t(3), _str.size() - _pos});
+        _str.copy(buffer, count, _pos);
+        _pos += count;
+        return count;
+    }
+
+private:
+    std::string _str;
+    std::size_t _pos;
+};
+
+struct production
+{
+    static constexpr auto line
+        = LEXY_LIT("abc") >> lexy::dsl::while_(lexy::dsl::ascii::alpha) + lexy::dsl::newline;
+    static constexpr auto rule = lexy::dsl::list(line) + lexy::dsl::eof;
+};
+} // namespace
+
+TEST_CASE("stream_input")
+{
+    SUBCASE("reader")
+    {
+        lexy::stream_input input(test_source("abcdefghij"), 4, 2);
+        CHECK(input.max_lookahead() == 4);
+
+        auto reader = input.reader();
+        auto begin  = reader.cur();
+        for (auto c : {'a', 'b', 'c', 'd', 'e', 'f', 'g'})
+        {
+            CHECK(!reader.eof());
+            CHECK(reader.peek() == c);
+            reader.bump();
+        }
+        CHECK(reader.cur().position() == 7);
+        CHECK(input.is_available(4));
+        CHECK(*begin == 'a');
+
+        // Backtracking within the window.
+        auto copy = reader;
+        CHECK(copy.peek() == 'h');
+        copy.bump();
+        CHECK(copy.peek() == 'i');
+        CHECK(reader.peek() == 'h');
+
+        // Reading 'i' discarded the first chunk.
+        CHECK(!input.is_available(0));
+        CHECK(!input.is_available(3));
+        CHECK(input.is_available(4));
+
+        reader.bump();
+        CHECK(reader.peek() == 'i');
+        reader.bump();
+        CHECK(reader.peek() == 'j');
+        reader.bump();
+        CHECK(reader.eof());
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.cur().position() == 10);
+    }
+    SUBCASE("pinned")
+    {
+        lexy::stream_input input(test_source("abcdefghijklmnopqrstuvwxyz012345"), 4, 2);
+
+        auto reader = input.reader();
+        CHECK(reader.peek() == 'a');
+        reader.bump();
+        {
+            // The copy pins the first chunk, so the ring grows instead of discarding it.
+            auto copy = reader;
+            while (reader.cur().position() != 12)
+            {
+                CHECK(!reader.eof());
+                reader.bump();
+            }
+            CHECK(reader.peek() == 'm');
+            CHECK(input.is_available(1));
+            CHECK(copy.peek() == 'b');
+        }
+
+        // Once the copy is gone, chunks are discarded again.
+        while (!reader.eof())
+            reader.bump();
+        CHECK(reader.cur().position() == 32);
+        CHECK(!input.is_available(1));
+        CHECK(input.is_available(31));
+    }
+    SUBCASE("overflow")
+    {
+        CHECK_THROWS_AS(lexy::stream_input(test_source(""), std::size_t(-1) / 2, 4),
+                        std::bad_array_new_length);
+    }
+    SUBCASE("empty")
+    {
+        lexy::stream_input input(test_source(""), 4, 2);
+        auto               reader = input.reader();
+        CHECK(reader.eof());
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("match")
+    {
+        std::string str;
+        for (auto i = 0; i != 1000; ++i)
+            str += "abcdefghijklmnopqrstuvwxyz\n";
+
+        lexy::stream_input input(test_source(str), 16, 4);
+        CHECK(lexy::match<production>(input));
+        CHECK(!input.is_available(0));
+
+        lexy::stream_input invalid(test_source(str + "abc123\n"), 16, 4);
+        CHECK(!lexy::match<production>(invalid));
+    }
+    SUBCASE("file_source")
+    {
+        auto file = std::tmpfile();
+        REQUIRE(file);
+        std::fputs("abc\nabcd\n", file);
+        std::rewind(file);
+
+        lexy::stream_input input(lexy::file_source<>{file});
+        CHECK(lexy::match<production>(input));
+        CHECK(!input.source().error());
+
+        std::fclose(file);
+    }
+    SUBCASE("file_source error")
+    {
+        // Reading from a file opened for writing fails.
+        constexpr auto file_name = "lexy-input-stream_input.test.delete-me";
+        auto           file      = std::fopen(file_name, "wb");
+        REQUIRE(file);
+
+        lexy::stream_input input(lexy::file_source<>{file});
+        CHECK(input.reader().eof());
+        CHECK(input.source().error());
+
+        std::fclose(file);
+        std::remove(file_name);
+    }
+}
+
@@ -243,6 +243,220 @@ TEST_CASE("parse_tree::builder")
     }
 }
 
+namespace
+{
+struct counting_resource
+{
+    int allocations = 0;
+
+    void* allocate(std::size_t bytes, std::size_t)
+    {
+        ++allocations;
+        return ::operator new(bytes);
+    }
+    void deallocate(void* ptr, std::size_t, std::size_t) noexcept
+    {
+        --allocations;
+        ::operator delete(ptr);
+    }
+
+    bool operator==(const counting_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+};
+} // namespace
+
+TEST_CASE("parse_tree::builder backtracking")
+{
+    using parse_tree = lexy::parse_tree<lexy::input_reader<lexy::string_input<>>, token_kind,
+                                        counting_resource>;
+    auto input = lexy::zstring_input("123(abc)321");
+
+    counting_resource resource;
+    parse_tree        tree(&resource);
+
+    // Enough tokens to span multiple blocks.
+    constexpr auto many_count = 1024u;
+    auto           build      = [&](unsigned backtrack_count) {
+        parse_tree::builder builder(LEXY_MOV(tree), root_p{});
+
+        for (auto i = 0u; i != backtrack_count; ++i)
+        {
+            auto child = builder.start_production(child_p{});
+            for (auto j = 0u; j != many_count; ++j)
+                builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+            builder.backtrack_production(LEXY_MOV(child));
+        }
+
+        builder.token(token_kind::a, input.begin(), input.begin() + 3);
+        auto child = builder.start_production(child_p{});
+        for (auto j = 0u; j != many_count; ++j)
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+        builder.finish_production(LEXY_MOV(child));
+
+        tree = LEXY_MOV(builder).finish();
+    };
+    auto expected = [&] {
+        lexy_ext::parse_tree_desc<token_kind> result(root_p{});
+        result.token(token_kind::a, "123").production(child_p{});
+        for (auto j = 0u; j != many_count; ++j)
+            result.token(token_kind::c, "abc");
+        return result;
+    }();
+
+    build(0);
+    CHECK(tree == expected);
+    auto allocations = resource.allocations;
+    CHECK(allocations > 1);
+
+    // Backtracking re-uses the blocks, so we don't need any more memory.
+    build(1);
+    CHECK(tree == expected);
+    CHECK(resource.allocations == allocations);
+
+    build(16);
+    CHECK(tree == expected);
+    CHECK(resource.allocations == allocations);
+
+    tree = parse_tree(&resource);
+    CHECK(resource.allocations == 0);
+}
+
+TEST_CASE("parse_tree block sizes and trim")
+{
+    using parse_tree = lexy::parse_tree<lexy::input_reader<lexy::string_input<>>, token_kind,
+                                        counting_resource>;
+    auto input = lexy::zstring_input("123(abc)321");
+
+    counting_resource resource;
+    auto              build = [&](parse_tree&& tree, unsigned count) {
+        parse_tree::builder builder(LEXY_MOV(tree), root_p{});
+        for (auto i = 0u; i != count; ++i)
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+        return LEXY_MOV(builder).finish();
+    };
+
+    SUBCASE("fixed size")
+    {
+        auto tree = build(parse_tree(&resource), 4096u);
+        CHECK(tree.capacity() == static_cast<std::size_t>(resource.allocations) * 4096u);
+        CHECK(resource.allocations > 8);
+    }
+    SUBCASE("geometric growth")
+    {
+        auto tree = build(parse_tree(&resource, {4096, 1024 * 1024}), 4096u);
+        CHECK(resource.allocations <= 5);
+
+        auto capacity = tree.capacity();
+        CHECK(capacity >= 4096u * 3 * sizeof(void*));
+
+        // Re-using the tree doesn't allocate.
+        auto allocations = resource.allocations;
+        tree             = build(LEXY_MOV(tree), 4096u);
+        CHECK(resource.allocations == allocations);
+        CHECK(tree.capacity() == capacity);
+    }
+    SUBCASE("trim")
+    {
+        auto tree = build(parse_tree(&resource, {4096, 1024 * 1024}), 4096u);
+
+        tree.trim(3 * 4096);
+        CHECK(tree.empty());
+        CHECK(tree.capacity() == 3 * 4096);
+        CHECK(resource.allocations == 2);
+
+        tree = build(LEXY_MOV(tree), 1u);
+        CHECK(resource.allocations == 2);
+        CHECK(!tree.empty());
+
+        tree.trim(0);
+        CHECK(tree.empty());
+        CHECK(tree.capacity() == 0);
+        CHECK(resource.allocations == 0);
+
+        tree = build(LEXY_MOV(tree), 1u);
+        CHECK(resource.allocations == 1);
+    }
+}
+
+TEST_CASE("parse_tree_pool")
+{
+    using pool_type = lexy::parse_tree_pool<lexy::input_reader<lexy::string_input<>>, token_kind,
+                                            counting_resource>;
+    using parse_tree = pool_type::tree_type;
+    auto input       = lexy::zstring_input("123(abc)321");
+
+    counting_resource resource;
+    auto              build = [&](parse_tree&& tree, unsigned count) {
+        parse_tree::builder builder(LEXY_MOV(tree), root_p{});
+        for (auto i = 0u; i != count; ++i)
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+        return LEXY_MOV(builder).finish();
+    };
+
+    SUBCASE("acquire and release")
+    {
+        pool_type pool(&resource, {4096, 64 * 1024});
+        CHECK(pool.size() == 0);
+
+        auto tree = build(pool.acquire(), 1024u);
+        CHECK(tree.root().kind() == root_p{});
+        auto allocations = resource.allocations;
+
+        pool.release(LEXY_MOV(tree));
+        CHECK(pool.size() == 1);
+        CHECK(resource.allocations > allocations); // the pool's storage
+
+        // The next tree re-uses the memory.
+        allocations = resource.allocations;
+        tree        = build(pool.acquire(), 1024u);
+        CHECK(pool.size() == 0);
+        CHECK(resource.allocations == allocations);
+        CHECK(tree.root().kind() == root_p{});
+    }
+    SUBCASE("retained capacity")
+    {
+        pool_type pool(&resource, {4096, 64 * 1024}, 4096);
+
+        auto big = build(pool.acquire(), 1024u);
+        CHECK(big.capacity() > 4096);
+        pool.release(LEXY_MOV(big));
+        CHECK(pool.size() == 1);
+
+        auto tree = pool.acquire();
+        CHECK(tree.empty());
+        CHECK(tree.capacity() == 4096);
+    }
+    SUBCASE("reserve")
+    {
+        pool_type pool(&resource);
+        pool.reserve(20);
+        CHECK(pool.size() == 20);
+
+        auto allocations = resource.allocations;
+        auto tree        = build(pool.acquire(), 1u);
+        CHECK(resource.allocations == allocations);
+        CHECK(pool.size() == 19);
+    }
+    SUBCASE("reserve with retained capacity of the first block")
+    {
+        pool_type pool(&resource, {1024, 64 * 1024}, 1024);
+        pool.reserve(3);
+        CHECK(pool.size() == 3);
+
+        auto big = build(pool.acquire(), 1024u);
+        CHECK(big.capacity() > 1024);
+        pool.release(LEXY_MOV(big));
+        CHECK(pool.size() == 3);
+
+        auto tree = pool.acquire();
+        CHECK(tree.capacity() == 1024);
+    }
+
+    CHECK(resource.allocations == 0);
+}
+
 namespace
 {
 template <typename Production, typename NodeKind>
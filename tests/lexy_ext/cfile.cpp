@@ -5,6 +5,7 @@
 #include <lexy_ext/cfile.hpp>
 
 #include <doctest/doctest.h>
+#include <string>
 
 #if defined(__has_include) && __has_include(<memory_resource>)
 #    include <memory_resource>
@@ -163,6 +164,70 @@ TEST_CASE("read_file")
 
         std::fclose(file);
     }
+    SUBCASE("large file")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 100 * 1024; ++i)
+                std::fputc('a' + i % 26, file);
+            std::fclose(file);
+        }
+
+        auto file = std::fopen(test_file_name, "rb");
+        // Skip the first characters, which aren't part of the input.
+        std::fgetc(file);
+        std::fgetc(file);
+
+        auto buffer = lexy_ext::read_file(file);
+        REQUIRE(buffer);
+        REQUIRE(buffer.value().size() == 100 * 1024 - 2);
+        for (auto i = 2; i != 100 * 1024; ++i)
+            REQUIRE(buffer.value().data()[i - 2] == 'a' + i % 26);
+
+        std::fclose(file);
+    }
+    SUBCASE("large file, byte order")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 100 * 1024; ++i)
+            {
+                std::fputc(0, file);
+                std::fputc('a' + i % 26, file);
+            }
+            std::fclose(file);
+        }
+
+        auto file = std::fopen(test_file_name, "rb");
+        auto buffer
+            = lexy_ext::read_file<lexy::utf16_encoding, lexy::encoding_endianness::big>(file);
+        REQUIRE(buffer);
+        REQUIRE(buffer.value().size() == 100 * 1024);
+        for (auto i = 0; i != 100 * 1024; ++i)
+            REQUIRE(buffer.value().data()[i] == 'a' + i % 26);
+
+        std::fclose(file);
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    SUBCASE("pipe")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 100 * 1024; ++i)
+                std::fputc('a' + i % 26, file);
+            std::fclose(file);
+        }
+
+        auto pipe   = ::popen((std::string("cat ") + test_file_name).c_str(), "r");
+        auto buffer = lexy_ext::read_file(pipe);
+        REQUIRE(buffer);
+        REQUIRE(buffer.value().size() == 100 * 1024);
+        for (auto i = 0; i != 100 * 1024; ++i)
+            REQUIRE(buffer.value().data()[i] == 'a' + i % 26);
+
+        ::pclose(pipe);
+    }
+#endif
 
     std::remove(test_file_name);
 }
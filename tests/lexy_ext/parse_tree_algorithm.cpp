@@ -185,6 +185,151 @@ TEST_CASE("find_covering_node()")
     CHECK(c.lexeme().begin() == input.begin() + 4);
 }
 
+TEST_CASE("parent_index")
+{
+    using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("123(abc)321");
+
+    SUBCASE("empty tree")
+    {
+        parse_tree tree;
+        lexy_ext::parent_index index(tree);
+        (void)index;
+    }
+    SUBCASE("nested")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{});
+            builder.token(token_kind::a, input.begin(), input.begin() + 3);
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+            builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+            builder.token(token_kind::b, input.begin() + 7, input.begin() + 8);
+            builder.finish_production(LEXY_MOV(child));
+
+            builder.token(token_kind::a, input.begin() + 8, input.end());
+
+            child      = builder.start_production(child_p{});
+            auto inner = builder.start_production(child_p{});
+            builder.finish_production(LEXY_MOV(inner));
+            builder.finish_production(LEXY_MOV(child));
+
+            return LEXY_MOV(builder).finish();
+        }();
+
+        lexy_ext::parent_index index(tree);
+        CHECK(index.parent(tree.root()) == tree.root());
+
+        auto count = 0;
+        for (auto [event, node] : tree.traverse())
+            if (event != lexy::traverse_event::exit)
+            {
+                CHECK(index.parent(node) == node.parent());
+                ++count;
+            }
+        CHECK(count == 9);
+    }
+    SUBCASE("long list")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{});
+            for (auto i = 0; i != 1000; ++i)
+            {
+                auto child = builder.start_production(child_p{});
+                builder.token(token_kind::a, input.begin(), input.begin() + 3);
+                builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+                builder.finish_production(LEXY_MOV(child));
+                builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+            }
+            return LEXY_MOV(builder).finish();
+        }();
+
+        lexy_ext::parent_index index(tree);
+        for (auto [event, node] : tree.traverse())
+            if (event != lexy::traverse_event::exit)
+                CHECK(index.parent(node) == node.parent());
+    }
+}
+
+TEST_CASE("token_index")
+{
+    using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("123(abc)321");
+
+    SUBCASE("empty tree")
+    {
+        parse_tree            tree;
+        lexy_ext::token_index index(tree);
+        CHECK(index.size() == 0);
+        CHECK(index.tokens(input.begin(), input.end()).empty());
+    }
+
+    auto tree = [&] {
+        parse_tree::builder builder(root_p{});
+        builder.token(token_kind::a, input.begin(), input.begin() + 3);
+
+        auto child = builder.start_production(child_p{});
+
+        auto child2 = builder.start_production(child_p{});
+        builder.finish_production(LEXY_MOV(child2));
+
+        child2 = builder.start_production(child_p{});
+        builder.token(token_kind::b, input.begin() + 3, input.begin() + 4);
+        builder.token(token_kind::c, input.begin() + 4, input.begin() + 7);
+        builder.token(token_kind::b, input.begin() + 7, input.begin() + 8);
+        builder.finish_production(LEXY_MOV(child2));
+
+        builder.finish_production(LEXY_MOV(child));
+
+        builder.token(token_kind::a, input.begin() + 8, input.end());
+
+        child  = builder.start_production(child_p{});
+        child2 = builder.start_production(child_p{});
+        builder.finish_production(LEXY_MOV(child2));
+        builder.finish_production(LEXY_MOV(child));
+
+        return LEXY_MOV(builder).finish();
+    }();
+    lexy_ext::token_index index(tree);
+    CHECK(index.size() == 5);
+
+    SUBCASE("node_position")
+    {
+        for (auto [event, node] : tree.traverse())
+            if (event != lexy::traverse_event::exit)
+                CHECK(index.node_position(node) == lexy_ext::node_position(tree, node));
+    }
+    SUBCASE("find_covering_node")
+    {
+        for (auto pos = input.begin(); pos != input.end(); ++pos)
+            CHECK(index.find_covering_node(pos) == lexy_ext::find_covering_node(tree, pos));
+    }
+    SUBCASE("tokens")
+    {
+        auto to_string = [](auto range) {
+            doctest::String result;
+            for (auto token : range)
+            {
+                result += doctest::String(token.lexeme().data(), unsigned(token.lexeme().size()));
+                result += "|";
+            }
+            return result;
+        };
+
+        CHECK(to_string(index.tokens(input.begin(), input.end())) == "123|(|abc|)|321|");
+        CHECK(to_string(index.tokens(input.begin() + 1, input.begin() + 2)) == "123|");
+        CHECK(to_string(index.tokens(input.begin() + 2, input.begin() + 5)) == "123|(|abc|");
+        CHECK(to_string(index.tokens(input.begin() + 3, input.begin() + 4)) == "(|");
+        CHECK(to_string(index.tokens(input.begin() + 7, input.begin() + 9)) == ")|321|");
+
+        CHECK(index.tokens(input.begin() + 3, input.begin() + 3).empty());
+        CHECK(index.tokens(input.begin() + 5, input.begin() + 5).empty());
+        CHECK(index.tokens(input.end(), input.end()).empty());
+        CHECK(index.tokens(input.begin(), input.end()).size() == 5);
+    }
+}
+
 TEST_CASE("children()")
 {
     using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;